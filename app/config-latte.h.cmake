@@ -3,6 +3,8 @@
 
 #cmakedefine01 HAVE_X11
 
+#cmakedefine01 BUILD_DEVELOPER_TOOLS
+
 #cmakedefine VERSION "@VERSION@"
 
 #cmakedefine WEBSITE "@WEBSITE@"
@@ -26,6 +26,8 @@
 #include "lattedockadaptor.h"
 #include "launcherssignals.h"
 #include "layoutmanager.h"
+#include "pointersampler.h"
+#include "schemesregistry.h"
 #include "screenpool.h"
 #include "shortcuts/globalshortcuts.h"
 #include "package/lattepackage.h"
@@ -34,18 +36,29 @@
 #include "settings/universalsettings.h"
 #include "view/view.h"
 #include "wm/abstractwindowinterface.h"
+#include "wm/dynamicbackgroundtracker.h"
 #include "wm/waylandinterface.h"
+#include "wm/windowstrace.h"
 #include "wm/xwindowinterface.h"
 
+#if BUILD_DEVELOPER_TOOLS
+    #include "wm/syntheticwindowinterface.h"
+    #include "wm/windowstraceplayer.h"
+#endif
+
 // Qt
 #include <QAction>
 #include <QApplication>
 #include <QScreen>
 #include <QDBusConnection>
+#include <QDBusMetaType>
 #include <QDebug>
 #include <QDesktopWidget>
 #include <QFile>
 #include <QFontDatabase>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QQmlContext>
 
 // Plasma
@@ -72,7 +85,9 @@
 
 namespace Latte {
 
-Corona::Corona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp, int userSetMemoryUsage, QObject *parent)
+Corona::Corona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp, int userSetMemoryUsage,
+               bool syntheticWindows,
+               QObject *parent)
     : Plasma::Corona(parent),
       m_defaultLayoutOnStartup(defaultLayoutOnStartup),
       m_userSetMemoryUsage(userSetMemoryUsage),
@@ -82,6 +97,7 @@ Corona::Corona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp, int use
       m_globalShortcuts(new GlobalShortcuts(this)),
       m_universalSettings(new UniversalSettings(KSharedConfig::openConfig(), this)),
       m_plasmaScreenPool(new PlasmaExtended::ScreenPool(this)),
+      m_schemesRegistry(new SchemesRegistry(this)),
       m_themeExtended(new PlasmaExtended::Theme(KSharedConfig::openConfig(), this)),
       m_layoutManager(new LayoutManager(this))
 {
@@ -93,6 +109,18 @@ Corona::Corona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp, int use
         m_wm = new XWindowInterface(this);
     }
 
+#if BUILD_DEVELOPER_TOOLS
+    if (syntheticWindows) {
+        m_syntheticWm = new SyntheticWindowInterface(m_wm, this);
+    }
+#else
+    //! the synthetic window tracking is built only with the developers tools
+    Q_UNUSED(syntheticWindows);
+#endif
+
+    m_dynamicBackgroundTracker = new DynamicBackgroundTracker(this);
+    m_pointerSampler = new PointerSampler(this);
+
     setupWaylandIntegration();
 
     KPackage::Package package(new Latte::Package(this));
@@ -129,6 +157,7 @@ Corona::Corona(bool defaultLayoutOnStartup, QString layoutNameOnStartUp, int use
     });
 
     //! Dbus adaptor initialization
+    qDBusRegisterMetaType<QMap<uint, QString>>();
     new LatteDockAdaptor(this);
     QDBusConnection dbus = QDBusConnection::sessionBus();
     dbus.registerObject(QStringLiteral("/Latte"), this);
@@ -382,9 +411,40 @@ LayoutManager *Corona::layoutManager() const
 
 AbstractWindowInterface *Corona::wm() const
 {
+    if (m_syntheticWm) {
+        return m_syntheticWm;
+    }
+
     return m_wm;
 }
 
+DynamicBackgroundTracker *Corona::dynamicBackgroundTracker() const
+{
+    return m_dynamicBackgroundTracker;
+}
+
+PointerSampler *Corona::pointerSampler() const
+{
+    return m_pointerSampler;
+}
+
+void Corona::recordWindows(const QString &file)
+{
+    new WindowsTraceRecorder(wm(), file, this);
+}
+
+#if BUILD_DEVELOPER_TOOLS
+void Corona::replayWindows(const QString &file)
+{
+    if (!m_syntheticWm) {
+        return;
+    }
+
+    auto player = new WindowsTracePlayer(m_syntheticWm, file, this);
+    player->start();
+}
+#endif
+
 PlasmaExtended::ScreenPool *Corona::plasmaScreenPool() const
 {
     return m_plasmaScreenPool;
@@ -916,7 +976,47 @@ void Corona::windowColorScheme(QString windowIdAndScheme)
     QString windowIdStr = windowIdAndScheme.mid(0, firstSlash);
     QString schemeStr = windowIdAndScheme.mid(firstSlash + 1);
 
-    m_wm->setColorSchemeForWindow(windowIdStr, schemeStr);
+    wm()->setColorSchemeForWindow(windowIdStr.toUInt(), schemeStr);
+}
+
+void Corona::windowColorSchemes(const QMap<uint, QString> &windowsSchemes)
+{
+    QHash<WindowId, QString> schemes;
+
+    for (auto it = windowsSchemes.constBegin(); it != windowsSchemes.constEnd(); ++it) {
+        schemes[it.key()] = it.value();
+    }
+
+    wm()->setColorSchemeForWindows(schemes);
+}
+
+QString Corona::visibilityProfilingData()
+{
+    QJsonArray views;
+
+    for (const auto &layoutName : m_layoutManager->activeLayoutsNames()) {
+        auto latteViews = m_layoutManager->layoutLatteViews(layoutName);
+
+        if (!latteViews) {
+            continue;
+        }
+
+        for (const auto view : *latteViews) {
+            if (!view->visibility()) {
+                continue;
+            }
+
+            QVariantMap data = view->visibility()->profilingData();
+            data["layout"] = layoutName;
+            data["containment"] = view->containment()->id();
+            data["screen"] = view->positioner() ? view->positioner()->currentScreenName() : QString();
+            data["mode"] = static_cast<int>(view->visibility()->mode());
+
+            views.append(QJsonObject::fromVariantMap(data));
+        }
+    }
+
+    return QString::fromUtf8(QJsonDocument(views).toJson());
 }
 
 //! update badge for specific view item
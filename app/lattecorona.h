@@ -22,10 +22,12 @@
 #define LATTECORONA_H
 
 // local
+#include <config-latte.h>
 #include "plasma/quick/configview.h"
 #include "../liblatte2/types.h"
 
 // Qt
+#include <QMap>
 #include <QObject>
 #include <QTimer>
 
@@ -61,11 +63,15 @@ class PlasmaShell;
 
 namespace Latte {
 class AbstractWindowInterface;
+class DynamicBackgroundTracker;
+class PointerSampler;
+class SyntheticWindowInterface;
 class ScreenPool;
 class GlobalShortcuts;
 class UniversalSettings;
 class LayoutManager;
 class LaunchersSignals;
+class SchemesRegistry;
 namespace PlasmaExtended{
 class ScreenPool;
 class Theme;
@@ -83,6 +89,7 @@ public:
     Corona(bool defaultLayoutOnStartup = false,
                QString layoutNameOnStartUp = QString(),
                int userSetMemoryUsage = -1,
+               bool syntheticWindows = false,
                QObject *parent = nullptr);
     virtual ~Corona();
 
@@ -104,7 +111,16 @@ public:
 
     void closeApplication();
 
+    //! developers tools, the window manager events are written in a trace file
+    void recordWindows(const QString &file);
+#if BUILD_DEVELOPER_TOOLS
+    //! developers tools, the replay needs the synthetic window tracking
+    void replayWindows(const QString &file);
+#endif
+
     AbstractWindowInterface *wm() const;
+    DynamicBackgroundTracker *dynamicBackgroundTracker() const;
+    PointerSampler *pointerSampler() const;
     KActivities::Consumer *activitiesConsumer() const;
     GlobalShortcuts *globalShortcuts() const;
     ScreenPool *screenPool() const;
@@ -126,6 +142,10 @@ public slots:
     void activateLauncherMenu();
     //! they are separated with a "-" character
     void windowColorScheme(QString windowIdAndScheme);
+    //! window id and scheme pairs, applied all together
+    void windowColorSchemes(const QMap<uint, QString> &windowsSchemes);
+    //! visibility counters and timings of all the views as a json document
+    QString visibilityProfilingData();
     void loadDefaultLayout() override;
     void updateDockItemBadge(QString identifier, QString value);
     void unload();
@@ -176,12 +196,18 @@ private:
     QPointer<KAboutApplicationDialog> aboutDialog;
 
     AbstractWindowInterface *m_wm{nullptr};
+    //! when it is set the views are using it instead of the real window manager tracking
+    SyntheticWindowInterface *m_syntheticWm{nullptr};
+    DynamicBackgroundTracker *m_dynamicBackgroundTracker{nullptr};
+    PointerSampler *m_pointerSampler{nullptr};
     ScreenPool *m_screenPool{nullptr};
     GlobalShortcuts *m_globalShortcuts{nullptr};
     UniversalSettings *m_universalSettings{nullptr};
     LayoutManager *m_layoutManager{nullptr};
 
     PlasmaExtended::ScreenPool *m_plasmaScreenPool{nullptr};
+    //! created before and destroyed after the schemes that are using it
+    SchemesRegistry *m_schemesRegistry{nullptr};
     PlasmaExtended::Theme *m_themeExtended{nullptr};
 
     KWayland::Client::PlasmaShell *m_waylandCorona{nullptr};
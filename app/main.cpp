@@ -24,6 +24,10 @@
 #include "lattecorona.h"
 #include "../liblatte2/types.h"
 
+#if BUILD_DEVELOPER_TOOLS
+    #include "wm/windowstraceplayer.h"
+#endif
+
 // C++
 #include <memory>
 #include <csignal>
@@ -130,6 +134,12 @@ int main(int argc, char **argv)
     timersOption.setHidden(true);
     parser.addOption(timersOption);
 
+    QCommandLineOption recordWindowsOption(QStringList() << QStringLiteral("record-windows"));
+    recordWindowsOption.setDescription(QStringLiteral("Record the window manager events in a binary trace file (Only useful to devs)."));
+    recordWindowsOption.setValueName(QStringLiteral("file_name"));
+    recordWindowsOption.setHidden(true);
+    parser.addOption(recordWindowsOption);
+
     QCommandLineOption spacersOption(QStringList() << QStringLiteral("spacers"));
     spacersOption.setDescription(QStringLiteral("Show visual indicators for debugging spacers (Only useful to devs)."));
     spacersOption.setHidden(true);
@@ -139,6 +149,14 @@ int main(int argc, char **argv)
     overloadedIconsOption.setDescription(QStringLiteral("Show visual indicators for debugging overloaded applets icons (Only useful to devs)."));
     overloadedIconsOption.setHidden(true);
     parser.addOption(overloadedIconsOption);
+
+#if BUILD_DEVELOPER_TOOLS
+    QCommandLineOption replayWindowsOption(QStringList() << QStringLiteral("replay-windows"));
+    replayWindowsOption.setDescription(QStringLiteral("Replay a recorded windows trace file instead of tracking the real windows (Only useful to devs)."));
+    replayWindowsOption.setValueName(QStringLiteral("file_name"));
+    replayWindowsOption.setHidden(true);
+    parser.addOption(replayWindowsOption);
+#endif
     //! END: Hidden options
 
     parser.process(app);
@@ -228,7 +246,21 @@ int main(int argc, char **argv)
         memoryUsage = (int)(Latte::Types::SingleLayout);
     }
 
-    if (parser.isSet(QStringLiteral("debug")) || parser.isSet(QStringLiteral("mask"))) {
+    //! the windows trace replay drives the views through the synthetic windows tracking
+    bool syntheticWindows{false};
+
+#if BUILD_DEVELOPER_TOOLS
+    if (parser.isSet(QStringLiteral("replay-windows"))) {
+        syntheticWindows = Latte::WindowsTracePlayer::isTrace(parser.value(QStringLiteral("replay-windows")));
+
+        if (!syntheticWindows) {
+            qWarning() << "windows trace:" << parser.value(QStringLiteral("replay-windows"))
+                       << "is not a valid windows trace, the real windows are tracked instead...";
+        }
+    }
+#endif
+
+    if (parser.isSet(QStringLiteral("debug")) || parser.isSet(QStringLiteral("mask")) || syntheticWindows) {
         //! set pattern for debug messages
         //! [%{type}] [%{function}:%{line}] - %{message} [%{backtrace}]
 
@@ -256,7 +288,19 @@ int main(int argc, char **argv)
     KCrash::setDrKonqiEnabled(true);
     KCrash::setFlags(KCrash::AutoRestart | KCrash::AlwaysDirectly);
 
-    Latte::Corona corona(defaultLayoutOnStartup, layoutNameOnStartup, memoryUsage);
+    Latte::Corona corona(defaultLayoutOnStartup, layoutNameOnStartup, memoryUsage, syntheticWindows);
+
+#if BUILD_DEVELOPER_TOOLS
+    if (syntheticWindows) {
+        corona.replayWindows(parser.value(QStringLiteral("replay-windows")));
+    }
+#endif
+
+    //! the synthetic windows are not recorded
+    if (parser.isSet(QStringLiteral("record-windows")) && !syntheticWindows) {
+        corona.recordWindows(parser.value(QStringLiteral("record-windows")));
+    }
+
     KDBusService service(KDBusService::Unique);
 
     return app.exec();
@@ -23,6 +23,7 @@
 // local
 #include "lattecorona.h"
 #include "schemecolors.h"
+#include "schemesregistry.h"
 #include "../../view/panelshadows_p.h"
 #include "../../../liblatte2/commontools.h"
 
@@ -31,7 +32,6 @@
 #include <QDir>
 
 // KDE
-#include <KDirWatch>
 #include <KConfigGroup>
 #include <KSharedConfig>
 
@@ -357,20 +357,8 @@ void Theme::loadThemePaths()
     } else {
         //! when plasma theme uses the kde colors
         //! we track when kde color scheme is changing
-        QString kdeSettingsFile = QDir::homePath() + "/.config/kdeglobals";
-
-        KDirWatch::self()->addFile(kdeSettingsFile);
-
-        m_kdeConnections[0] = connect(KDirWatch::self(), &KDirWatch::dirty, this, [ &, kdeSettingsFile](const QString & path) {
-            if (path == kdeSettingsFile) {
-                this->setOriginalSchemeFile(SchemeColors::possibleSchemeFile("kdeglobals"));
-            }
-        });
-
-        m_kdeConnections[1] = connect(KDirWatch::self(), &KDirWatch::created, this, [ &, kdeSettingsFile](const QString & path) {
-            if (path == kdeSettingsFile) {
-                this->setOriginalSchemeFile(SchemeColors::possibleSchemeFile("kdeglobals"));
-            }
+        m_kdeConnections[0] = connect(SchemesRegistry::self(), &SchemesRegistry::kdeglobalsChanged, this, [&]() {
+            this->setOriginalSchemeFile(SchemeColors::possibleSchemeFile("kdeglobals"));
         });
 
         setOriginalSchemeFile(SchemeColors::possibleSchemeFile("kdeglobals"));
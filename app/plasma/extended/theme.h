@@ -120,7 +120,7 @@ private:
     QString m_originalSchemePath;
     QString m_reversedSchemePath;
 
-    std::array<QMetaObject::Connection, 2> m_kdeConnections;
+    std::array<QMetaObject::Connection, 1> m_kdeConnections;
 
     QTemporaryDir m_extendedThemeDir;
     KConfigGroup m_themeGroup;
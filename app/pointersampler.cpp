@@ -0,0 +1,82 @@
+/*
+ * Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "pointersampler.h"
+
+// Qt
+#include <QCursor>
+
+namespace Latte {
+
+PointerSampler::PointerSampler(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_timer, &QTimer::timeout, this, &PointerSampler::sample);
+}
+
+PointerSampler::~PointerSampler()
+{
+    m_timer.stop();
+}
+
+void PointerSampler::request(const QObject *client, int interval)
+{
+    if (m_clients.value(client, -1) == interval) {
+        return;
+    }
+
+    m_clients[client] = interval;
+    updateInterval();
+}
+
+void PointerSampler::release(const QObject *client)
+{
+    if (m_clients.remove(client) > 0) {
+        updateInterval();
+    }
+}
+
+void PointerSampler::updateInterval()
+{
+    if (m_clients.isEmpty()) {
+        m_timer.stop();
+        return;
+    }
+
+    int interval = m_clients.constBegin().value();
+
+    for (const auto clientInterval : m_clients) {
+        interval = qMin(interval, clientInterval);
+    }
+
+    if (!m_timer.isActive()) {
+        m_sampleTime.start();
+        m_timer.start(interval);
+    } else if (m_timer.interval() != interval) {
+        m_timer.setInterval(interval);
+    }
+}
+
+void PointerSampler::sample()
+{
+    emit sampled(QCursor::pos(), m_sampleTime.restart());
+}
+
+}
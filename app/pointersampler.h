@@ -0,0 +1,68 @@
+/*
+ * Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef POINTERSAMPLER_H
+#define POINTERSAMPLER_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPoint>
+#include <QTimer>
+
+namespace Latte {
+
+//! Shared global pointer sampling for all the views. The pointer position is read
+//! once per sample for every view that requested it and the sampling runs only
+//! while at least one view is requesting it, at the fastest requested interval.
+class PointerSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PointerSampler(QObject *parent = nullptr);
+    ~PointerSampler() override;
+
+    //! a client that is already requesting just updates its interval
+    void request(const QObject *client, int interval);
+    void release(const QObject *client);
+
+signals:
+    //! elapsed, the ms since the previous sample
+    void sampled(const QPoint &pointer, qint64 elapsed);
+
+private slots:
+    void sample();
+
+private:
+    void updateInterval();
+
+private:
+    //! client and its requested interval
+    QHash<const QObject *, int> m_clients;
+
+    QElapsedTimer m_sampleTime;
+    QTimer m_timer;
+};
+
+}
+
+#endif
@@ -20,6 +20,9 @@
 
 #include "schemecolors.h"
 
+// local
+#include "schemesregistry.h"
+
 // Qt
 #include <QDebug>
 #include <QDir>
@@ -27,7 +30,6 @@
 
 // KDE
 #include <KConfigGroup>
-#include <KDirWatch>
 #include <KSharedConfig>
 
 namespace Latte {
@@ -39,90 +41,89 @@ SchemeColors::SchemeColors(QObject *parent, QString scheme, bool plasmaTheme) :
     QString pSchemeFile = possibleSchemeFile(scheme);
 
     if (QFileInfo(pSchemeFile).exists()) {
-        setSchemeFile(pSchemeFile);
+        m_schemeFile = pSchemeFile;
         m_schemeName = schemeName(pSchemeFile);
-
-        //! track scheme file for changes
-        KDirWatch::self()->addFile(m_schemeFile);
-
-        connect(KDirWatch::self(), &KDirWatch::dirty, this, [ & ](const QString & path) {
-            if (path == m_schemeFile) {
-                updateScheme();
-            }
-        });
     }
 
-    updateScheme();
+    //! the scheme file is parsed and tracked for changes by the registry
+    if (SchemesRegistry *registry = SchemesRegistry::self()) {
+        registry->addScheme(this);
+    } else {
+        qWarning() << "scheme" << scheme << "was created without a schemes registry...";
+        m_colors.reset(new SchemeColorsTable);
+    }
 }
 
 SchemeColors::~SchemeColors()
 {
-///
+    if (SchemesRegistry *registry = SchemesRegistry::self()) {
+        registry->removeScheme(this);
+    }
 }
 
 QColor SchemeColors::backgroundColor() const
 {
-    return m_activeBackgroundColor;
+    return m_colors->activeBackgroundColor;
 }
 
 QColor SchemeColors::textColor() const
 {
-    return m_activeTextColor;
+    return m_colors->activeTextColor;
 }
 
 QColor SchemeColors::inactiveBackgroundColor() const
 {
-    return m_inactiveBackgroundColor;
+    return m_colors->inactiveBackgroundColor;
 }
 
 QColor SchemeColors::inactiveTextColor() const
 {
-    return m_inactiveTextColor;
+    return m_colors->inactiveTextColor;
 }
 
 QColor SchemeColors::highlightColor() const
 {
-    return m_highlightColor;
+    return m_colors->highlightColor;
 }
 
 QColor SchemeColors::highlightedTextColor() const
 {
-    return m_highlightedTextColor;
+    return m_colors->highlightedTextColor;
 }
 
 QColor SchemeColors::positiveTextColor() const
 {
-    return m_positiveTextColor;
+    return m_colors->positiveTextColor;
 }
 
 QColor SchemeColors::neutralTextColor() const
 {
-    return m_neutralTextColor;
+    return m_colors->neutralTextColor;
 }
 
 QColor SchemeColors::negativeTextColor() const
 {
-    return m_negativeTextColor;
+    return m_colors->negativeTextColor;
 }
 
 QColor SchemeColors::buttonTextColor() const
 {
-    return m_buttonTextColor;
+    return m_colors->buttonTextColor;
 }
 
 QColor SchemeColors::buttonBackgroundColor() const
 {
-    return m_buttonBackgroundColor;
+    return m_colors->buttonBackgroundColor;
 }
 
 QColor SchemeColors::buttonHoverColor() const
 {
-    return m_buttonHoverColor;
+    return m_colors->buttonHoverColor;
 }
 
 QColor SchemeColors::buttonFocusColor() const
 {
-    return m_buttonFocusColor;
+    return m_colors->buttonFocusColor;
 }
 
 QString SchemeColors::schemeName() const
@@ -141,10 +142,37 @@ void SchemeColors::setSchemeFile(QString file)
         return;
     }
 
+    SchemesRegistry *registry = SchemesRegistry::self();
+
+    if (registry) {
+        registry->removeScheme(this);
+    }
+
     m_schemeFile = file;
+    m_schemeName = schemeName(file);
+
+    if (registry) {
+        registry->addScheme(this);
+    }
+
     emit schemeFileChanged();
 }
 
+bool SchemeColors::basedOnPlasmaTheme() const
+{
+    return m_basedOnPlasmaTheme;
+}
+
+void SchemeColors::setColors(const QSharedPointer<const SchemeColorsTable> &colors)
+{
+    if (m_colors == colors) {
+        return;
+    }
+
+    m_colors = colors;
+    emit colorsChanged();
+}
+
 QString SchemeColors::possibleSchemeFile(QString scheme)
 {
     if (scheme.startsWith("/") && scheme.endsWith("colors") && QFileInfo(scheme).exists()) {
@@ -202,44 +230,4 @@ QString SchemeColors::schemeName(QString originalFile)
     return generalGroup.readEntry("Name", fileNameNoExt);
 }
 
-void SchemeColors::updateScheme()
-{
-    if (m_schemeFile.isEmpty() || !QFileInfo(m_schemeFile).exists()) {
-        return;
-    }
-
-    KSharedConfigPtr filePtr = KSharedConfig::openConfig(m_schemeFile);
-    KConfigGroup wmGroup = KConfigGroup(filePtr, "WM");
-    KConfigGroup selGroup = KConfigGroup(filePtr, "Colors:Selection");
-    KConfigGroup viewGroup = KConfigGroup(filePtr, "Colors:View");
-    //KConfigGroup windowGroup = KConfigGroup(filePtr, "Colors:Window");
-    KConfigGroup buttonGroup = KConfigGroup(filePtr, "Colors:Button");
-
-    if (!m_basedOnPlasmaTheme) {
-        m_activeBackgroundColor = wmGroup.readEntry("activeBackground", QColor());
-        m_activeTextColor = wmGroup.readEntry("activeForeground", QColor());
-        m_inactiveBackgroundColor = wmGroup.readEntry("inactiveBackground", QColor());
-        m_inactiveTextColor = wmGroup.readEntry("inactiveForeground", QColor());
-    } else {
-        m_activeBackgroundColor = viewGroup.readEntry("BackgroundNormal", QColor());
-        m_activeTextColor = viewGroup.readEntry("ForegroundNormal", QColor());
-        m_inactiveBackgroundColor = viewGroup.readEntry("BackgroundAlternate", QColor());
-        m_inactiveTextColor = viewGroup.readEntry("ForegroundInactive", QColor());
-    }
-
-    m_highlightColor = selGroup.readEntry("BackgroundNormal", QColor());
-    m_highlightedTextColor = selGroup.readEntry("ForegroundNormal", QColor());
-
-    m_positiveTextColor = viewGroup.readEntry("ForegroundPositive", QColor());
-    m_neutralTextColor = viewGroup.readEntry("ForegroundNeutral", QColor());;
-    m_negativeTextColor = viewGroup.readEntry("ForegroundNegative", QColor());
-
-    m_buttonTextColor = buttonGroup.readEntry("ForegroundNormal", QColor());
-    m_buttonBackgroundColor = buttonGroup.readEntry("BackgroundNormal", QColor());
-    m_buttonHoverColor = buttonGroup.readEntry("DecorationHover", QColor());
-    m_buttonFocusColor = buttonGroup.readEntry("DecorationFocus", QColor());
-
-    emit colorsChanged();
-}
-
 }
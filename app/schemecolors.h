@@ -24,6 +24,11 @@
 // Qt
 #include <QObject>
 #include <QColor>
+#include <QSharedPointer>
+
+namespace Latte {
+struct SchemeColorsTable;
+}
 
 namespace Latte {
 
@@ -79,31 +84,20 @@ signals:
     void colorsChanged();
     void schemeFileChanged();
 
-private slots:
-    void updateScheme();
+private:
+    friend class SchemesRegistry;
+
+    bool basedOnPlasmaTheme() const;
+    void setColors(const QSharedPointer<const SchemeColorsTable> &colors);
 
 private:
     bool m_basedOnPlasmaTheme{false};
 
-    QString m_schemeName;
     QString m_schemeFile;
+    QString m_schemeName;
 
-    QColor m_activeBackgroundColor;
-    QColor m_activeTextColor;
-
-    QColor m_inactiveBackgroundColor;
-    QColor m_inactiveTextColor;
-
-    QColor m_highlightColor;
-    QColor m_highlightedTextColor;
-    QColor m_positiveTextColor;
-    QColor m_neutralTextColor;
-    QColor m_negativeTextColor;
-
-    QColor m_buttonTextColor;
-    QColor m_buttonBackgroundColor;
-    QColor m_buttonHoverColor;
-    QColor m_buttonFocusColor;
+    //! shared with all the schemes of the same file contents
+    QSharedPointer<const SchemeColorsTable> m_colors;
 };
 
 }
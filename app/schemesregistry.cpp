@@ -0,0 +1,206 @@
+/*
+ * Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "schemesregistry.h"
+
+// local
+#include "schemecolors.h"
+
+// Qt
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+
+// KDE
+#include <KConfig>
+#include <KConfigGroup>
+#include <KDirWatch>
+
+namespace Latte {
+
+SchemesRegistry *SchemesRegistry::s_self{nullptr};
+
+SchemesRegistry::SchemesRegistry(QObject *parent)
+    : QObject(parent),
+      m_kdeglobalsFile(QDir::homePath() + "/.config/kdeglobals"),
+      m_emptyColors(new SchemeColorsTable)
+{
+    Q_ASSERT(!s_self);
+    s_self = this;
+
+    KDirWatch::self()->addFile(m_kdeglobalsFile);
+
+    connect(KDirWatch::self(), &KDirWatch::dirty, this, &SchemesRegistry::fileChanged);
+    connect(KDirWatch::self(), &KDirWatch::created, this, &SchemesRegistry::fileChanged);
+}
+
+SchemesRegistry::~SchemesRegistry()
+{
+    //! schemes that outlive the registry keep their last colors
+    for (auto it = m_files.constBegin(); it != m_files.constEnd(); ++it) {
+        if (it.key() != m_kdeglobalsFile) {
+            KDirWatch::self()->removeFile(it.key());
+        }
+    }
+
+    KDirWatch::self()->removeFile(m_kdeglobalsFile);
+
+    s_self = nullptr;
+}
+
+SchemesRegistry *SchemesRegistry::self()
+{
+    return s_self;
+}
+
+void SchemesRegistry::addScheme(SchemeColors *scheme)
+{
+    const QString path = scheme->schemeFile();
+
+    if (path.isEmpty()) {
+        scheme->setColors(m_emptyColors);
+        return;
+    }
+
+    if (!m_files.contains(path)) {
+        KDirWatch::self()->addFile(path);
+    }
+
+    m_files[path].schemes.append(scheme);
+
+    //! the file may have changed since it was loaded for other schemes
+    reloadFile(path);
+
+    scheme->setColors(colors(path, m_files[path].hash, scheme->basedOnPlasmaTheme()));
+}
+
+void SchemesRegistry::removeScheme(SchemeColors *scheme)
+{
+    auto file = m_files.find(scheme->schemeFile());
+
+    if (file == m_files.end()) {
+        return;
+    }
+
+    file->schemes.removeAll(scheme);
+
+    if (file->schemes.isEmpty()) {
+        //! kdeglobals is always tracked
+        if (file.key() != m_kdeglobalsFile) {
+            KDirWatch::self()->removeFile(file.key());
+        }
+
+        m_files.erase(file);
+    }
+}
+
+void SchemesRegistry::fileChanged(const QString &path)
+{
+    if (path == m_kdeglobalsFile) {
+        emit kdeglobalsChanged();
+    }
+
+    if (m_files.contains(path)) {
+        reloadFile(path);
+    }
+}
+
+void SchemesRegistry::reloadFile(const QString &path)
+{
+    QByteArray hash;
+    QFile file(path);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        hash = QCryptographicHash::hash(file.readAll(), QCryptographicHash::Sha1);
+    }
+
+    SchemeFile &schemeFile = m_files[path];
+
+    //! file events without any content change are ignored
+    if (schemeFile.hash == hash) {
+        return;
+    }
+
+    schemeFile.hash = hash;
+
+    for (const auto scheme : schemeFile.schemes) {
+        scheme->setColors(colors(path, hash, scheme->basedOnPlasmaTheme()));
+    }
+}
+
+SchemesRegistry::Colors SchemesRegistry::colors(const QString &path, const QByteArray &hash, bool plasmaTheme)
+{
+    if (hash.isEmpty()) {
+        return m_emptyColors;
+    }
+
+    const QPair<QByteArray, bool> key{hash, plasmaTheme};
+
+    Colors cached = m_colors.value(key).toStrongRef();
+
+    if (cached) {
+        return cached;
+    }
+
+    //! a fresh config that is not shared with other KSharedConfig users
+    KConfig config(path, KConfig::SimpleConfig);
+    KConfigGroup wmGroup = KConfigGroup(&config, "WM");
+    KConfigGroup selGroup = KConfigGroup(&config, "Colors:Selection");
+    KConfigGroup viewGroup = KConfigGroup(&config, "Colors:View");
+    KConfigGroup buttonGroup = KConfigGroup(&config, "Colors:Button");
+
+    SchemeColorsTable *table = new SchemeColorsTable;
+
+    if (!plasmaTheme) {
+        table->activeBackgroundColor = wmGroup.readEntry("activeBackground", QColor());
+        table->activeTextColor = wmGroup.readEntry("activeForeground", QColor());
+        table->inactiveBackgroundColor = wmGroup.readEntry("inactiveBackground", QColor());
+        table->inactiveTextColor = wmGroup.readEntry("inactiveForeground", QColor());
+    } else {
+        table->activeBackgroundColor = viewGroup.readEntry("BackgroundNormal", QColor());
+        table->activeTextColor = viewGroup.readEntry("ForegroundNormal", QColor());
+        table->inactiveBackgroundColor = viewGroup.readEntry("BackgroundAlternate", QColor());
+        table->inactiveTextColor = viewGroup.readEntry("ForegroundInactive", QColor());
+    }
+
+    table->highlightColor = selGroup.readEntry("BackgroundNormal", QColor());
+    table->highlightedTextColor = selGroup.readEntry("ForegroundNormal", QColor());
+
+    table->positiveTextColor = viewGroup.readEntry("ForegroundPositive", QColor());
+    table->neutralTextColor = viewGroup.readEntry("ForegroundNeutral", QColor());
+    table->negativeTextColor = viewGroup.readEntry("ForegroundNegative", QColor());
+
+    table->buttonTextColor = buttonGroup.readEntry("ForegroundNormal", QColor());
+    table->buttonBackgroundColor = buttonGroup.readEntry("BackgroundNormal", QColor());
+    table->buttonHoverColor = buttonGroup.readEntry("DecorationHover", QColor());
+    table->buttonFocusColor = buttonGroup.readEntry("DecorationFocus", QColor());
+
+    //! forget the colors that are not used any more
+    for (auto it = m_colors.begin(); it != m_colors.end();) {
+        it = it.value().isNull() ? m_colors.erase(it) : it + 1;
+    }
+
+    Colors colors(table);
+    m_colors[key] = colors;
+
+    return colors;
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+ *
+ * This file is part of Latte-Dock
+ *
+ * Latte-Dock is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * Latte-Dock is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCHEMESREGISTRY_H
+#define SCHEMESREGISTRY_H
+
+// Qt
+#include <QByteArray>
+#include <QColor>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPair>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+namespace Latte {
+class SchemeColors;
+}
+
+namespace Latte {
+
+//! immutable colors of a scheme file, schemes with the same file contents share them.
+//! The scheme name depends on the file path so it is kept by each scheme
+struct SchemeColorsTable
+{
+    QColor activeBackgroundColor;
+    QColor activeTextColor;
+
+    QColor inactiveBackgroundColor;
+    QColor inactiveTextColor;
+
+    QColor highlightColor;
+    QColor highlightedTextColor;
+    QColor positiveTextColor;
+    QColor neutralTextColor;
+    QColor negativeTextColor;
+
+    QColor buttonTextColor;
+    QColor buttonBackgroundColor;
+    QColor buttonHoverColor;
+    QColor buttonFocusColor;
+};
+
+//! Process wide registry of the color scheme files. Each file content is parsed
+//! only once and it is tracked through a single KDirWatch dispatch, the schemes
+//! of a changed file are updated only when its content really changed.
+//! It is owned by the corona, self() is null before and after its lifetime.
+class SchemesRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SchemesRegistry(QObject *parent = nullptr);
+    ~SchemesRegistry() override;
+
+    static SchemesRegistry *self();
+
+    void addScheme(SchemeColors *scheme);
+    void removeScheme(SchemeColors *scheme);
+
+signals:
+    //! kdeglobals file changed, the default color scheme may be different
+    void kdeglobalsChanged();
+
+private slots:
+    void fileChanged(const QString &path);
+
+private:
+    using Colors = QSharedPointer<const SchemeColorsTable>;
+
+    struct SchemeFile {
+        QByteArray hash;
+        QList<SchemeColors *> schemes;
+    };
+
+    void reloadFile(const QString &path);
+    Colors colors(const QString &path, const QByteArray &hash, bool plasmaTheme);
+
+private:
+    QString m_kdeglobalsFile;
+
+    QHash<QString, SchemeFile> m_files;
+
+    //! content hash and plasma theme flag, the parsed colors are kept
+    //! only while there are schemes using them
+    QHash<QPair<QByteArray, bool>, QWeakPointer<const SchemeColorsTable>> m_colors;
+
+    Colors m_emptyColors;
+
+    static SchemesRegistry *s_self;
+};
+
+}
+
+#endif
@@ -24,9 +24,12 @@
 #include "positioner.h"
 #include "screenedgeghostwindow.h"
 #include "view.h"
+#include "windowsdodger.h"
 #include "../lattecorona.h"
 #include "../layoutmanager.h"
+#include "../pointersampler.h"
 #include "../screenpool.h"
+#include "../wm/dynamicbackgroundtracker.h"
 #include "../wm/windowinfowrap.h"
 #include "../../liblatte2/extras.h"
 
@@ -36,6 +39,7 @@
 // KDE
 #include <KWayland/Client/plasmashell.h>
 #include <KWayland/Client/surface.h>
+#include <KWindowSystem>
 
 namespace Latte {
 namespace ViewPart {
@@ -51,6 +55,9 @@ VisibilityManager::VisibilityManager(PlasmaQuick::ContainmentView *view)
     m_corona = qobject_cast<Latte::Corona *>(view->corona());
     wm = m_corona->wm();
 
+    m_windowsDodger = new WindowsDodger(wm, &m_profiler, this);
+    connect(m_windowsDodger, &WindowsDodger::raiseRequested, this, &VisibilityManager::dodge);
+
     if (m_latteView) {
         connect(m_latteView, &Latte::View::absGeometryChanged, this, &VisibilityManager::setViewGeometry);
         connect(m_latteView, &Latte::View::eventTriggered, this, &VisibilityManager::viewEventManager);
@@ -62,12 +69,15 @@ VisibilityManager::VisibilityManager(PlasmaQuick::ContainmentView *view)
 
     m_timerStartUp.setInterval(5000);
     m_timerStartUp.setSingleShot(true);
-    m_timerCheckWindows.setInterval(350);
-    m_timerCheckWindows.setSingleShot(true);
     m_timerShow.setSingleShot(true);
     m_timerHide.setSingleShot(true);
-    connect(&m_timerCheckWindows, &QTimer::timeout, this, &VisibilityManager::checkAllWindows);
     connect(&m_timerShow, &QTimer::timeout, this, [&]() {
+        if (predictedShow && !m_containsMouse) {
+            //! the pointer has not reached the view yet, it is shown when it does
+            predictedShowReady = true;
+            return;
+        }
+
         if (m_isHidden) {
             //   qDebug() << "must be shown";
             emit mustBeShown();
@@ -91,6 +101,12 @@ VisibilityManager::~VisibilityManager()
     wm->removeViewStruts(*m_latteView);
     wm->removeView(m_latteView->winId());
 
+    if (m_pointerSamplingConnection) {
+        m_corona->pointerSampler()->release(this);
+    }
+
+    unsubscribeDynamicBackground();
+
     if (edgeGhostWindow) {
         edgeGhostWindow->deleteLater();
     }
@@ -113,10 +129,6 @@ void VisibilityManager::setMode(Latte::Types::Visibility mode)
         disconnect(c);
     }
 
-    if (m_mode != Types::DodgeAllWindows && !enabledDynamicBackgroundFlag) {
-        windows.clear();
-    }
-
     if (m_mode == Types::AlwaysVisible) {
         wm->removeViewStruts(*m_latteView);
     } else {
@@ -134,11 +146,15 @@ void VisibilityManager::setMode(Latte::Types::Visibility mode)
         });
     }
 
+    cancelPredictedShow();
     m_timerShow.stop();
     m_timerHide.stop();
-    m_timerCheckWindows.stop();
     m_mode = mode;
 
+    //! the window states must be available before the dodge modes are evaluated
+    updateWindowsDodger();
+    m_windowsDodger->setMode(m_mode);
+
     switch (m_mode) {
         case Types::AlwaysVisible: {
             //set wayland visibility mode
@@ -185,58 +201,20 @@ void VisibilityManager::setMode(Latte::Types::Visibility mode)
         }
         break;
 
-        case Types::DodgeActive: {
-            //set wayland visibility mode
-            if (m_latteView->surface()) {
-                m_latteView->surface()->setPanelBehavior(KWayland::Client::PlasmaShellSurface::PanelBehavior::AutoHide);
-            }
-
-            connections[0] = connect(wm, &WindowSystem::activeWindowChanged
-                                     , this, &VisibilityManager::dodgeActive);
-            connections[1] = connect(wm, &WindowSystem::windowChanged
-                                     , this, &VisibilityManager::dodgeActive);
-            dodgeActive(wm->activeWindow());
-        }
-        break;
-
-        case Types::DodgeMaximized: {
-            //set wayland visibility mode
-            if (m_latteView->surface()) {
-                m_latteView->surface()->setPanelBehavior(KWayland::Client::PlasmaShellSurface::PanelBehavior::AutoHide);
-            }
-
-            connections[0] = connect(wm, &WindowSystem::activeWindowChanged
-                                     , this, &VisibilityManager::dodgeMaximized);
-            connections[1] = connect(wm, &WindowSystem::windowChanged
-                                     , this, &VisibilityManager::dodgeMaximized);
-            dodgeMaximized(wm->activeWindow());
-        }
-        break;
-
+        case Types::DodgeActive:
+        case Types::DodgeMaximized:
         case Types::DodgeAllWindows: {
             //set wayland visibility mode
             if (m_latteView->surface()) {
                 m_latteView->surface()->setPanelBehavior(KWayland::Client::PlasmaShellSurface::PanelBehavior::AutoHide);
             }
 
-            for (const auto &wid : wm->windows()) {
-                windows.insert(wid, wm->requestInfo(wid));
+            //!don't send false raiseView signal when containing mouse
+            if (m_containsMouse) {
+                raiseView(true);
+            } else {
+                m_windowsDodger->update();
             }
-
-            connections[0] = connect(wm, &WindowSystem::windowChanged
-                                     , this, &VisibilityManager::dodgeWindows);
-            connections[1] = connect(wm, &WindowSystem::windowRemoved
-            , this, [&](WindowId wid) {
-                windows.remove(wid);
-                m_timerCheckWindows.start();
-            });
-            connections[2] = connect(wm, &WindowSystem::windowAdded
-            , this, [&](WindowId wid) {
-                windows.insert(wid, wm->requestInfo(wid));
-                m_timerCheckWindows.start();
-            });
-
-            m_timerCheckWindows.start();
         }
         break;
 
@@ -256,6 +234,7 @@ void VisibilityManager::setMode(Latte::Types::Visibility mode)
     m_latteView->containment()->config().writeEntry("visibility", static_cast<int>(m_mode));
 
     updateKWinEdgesSupport();
+    updatePointerSampling();
 
     emit modeChanged();
 }
@@ -331,6 +310,8 @@ void VisibilityManager::setIsHidden(bool isHidden)
         }
     }
 
+    updatePointerSampling();
+
     emit isHiddenChanged();
 }
 
@@ -358,6 +339,8 @@ void VisibilityManager::setBlockHiding(bool blockHiding)
         updateHiddenState();
     }
 
+    updatePointerSampling();
+
     emit blockHidingChanged();
 }
 
@@ -369,6 +352,7 @@ int VisibilityManager::timerShow() const
 void VisibilityManager::setTimerShow(int msec)
 {
     m_timerShow.setInterval(msec);
+    updatePointerSampling();
     emit timerShowChanged();
 }
 
@@ -393,13 +377,27 @@ void VisibilityManager::raiseView(bool raise)
     if (m_blockHiding)
         return;
 
+    m_profiler.count(raise ? VisibilityProfiler::RaiseDecisions : VisibilityProfiler::HideDecisions);
+
     if (raise) {
         m_timerHide.stop();
 
-        if (!m_timerShow.isActive()) {
+        if (predictedShow) {
+            //! the show interval started already when the pointer was predicted to reach the view
+            predictedShow = false;
+
+            if (predictedShowReady) {
+                predictedShowReady = false;
+
+                if (m_isHidden) {
+                    emit mustBeShown();
+                }
+            }
+        } else if (!m_timerShow.isActive()) {
             m_timerShow.start();
         }
     } else if (!dragEnter) {
+        cancelPredictedShow();
         m_timerShow.stop();
 
         if (hideNow) {
@@ -430,194 +428,195 @@ void VisibilityManager::raiseViewTemporarily()
     });
 }
 
-void VisibilityManager::updateHiddenState()
+void VisibilityManager::updatePointerSampling()
 {
-    if (dragEnter)
-        return;
+    //! the global pointer position can be read only under X11 and
+    //! when there is no show interval there is nothing to gain
+    bool sampling = m_isHidden && !m_blockHiding && m_timerShow.interval() > 0
+                    && KWindowSystem::isPlatformX11()
+                    && (m_mode == Types::AutoHide
+                        || m_mode == Types::DodgeActive
+                        || m_mode == Types::DodgeMaximized
+                        || m_mode == Types::DodgeAllWindows);
+
+    if (sampling) {
+        if (!m_pointerSamplingConnection) {
+            m_lastPointerDistance = -1;
+            m_pointerSamplingInterval = FarSamplingInterval;
+            m_pointerSamplingConnection = connect(m_corona->pointerSampler(), &PointerSampler::sampled,
+                                                  this, &VisibilityManager::samplePointer);
+            m_corona->pointerSampler()->request(this, m_pointerSamplingInterval);
+        }
+    } else {
+        if (m_pointerSamplingConnection) {
+            disconnect(m_pointerSamplingConnection);
+            m_pointerSamplingConnection = QMetaObject::Connection();
+            m_corona->pointerSampler()->release(this);
+        }
 
-    switch (m_mode) {
-        case Types::AutoHide:
-            raiseView(m_containsMouse);
+        cancelPredictedShow();
+    }
+}
+
+void VisibilityManager::samplePointer(const QPoint &pointer, qint64 elapsed)
+{
+    VisibilityProfiler::Timing timing(&m_profiler, VisibilityProfiler::PointerSamplingHandler);
+    m_profiler.count(VisibilityProfiler::PointerSamples);
+
+    const QRect screenGeometry = m_latteView->screenGeometry();
+
+    //! distance from the screen edge and whether the pointer is in front of the view
+    int distance{-1};
+    bool inFront{false};
+
+    switch (m_latteView->location()) {
+        case Plasma::Types::BottomEdge:
+            distance = screenGeometry.bottom() - pointer.y();
+            inFront = pointer.x() >= m_viewGeometry.left() && pointer.x() <= m_viewGeometry.right();
             break;
 
-        case Types::DodgeActive:
-            dodgeActive(wm->activeWindow());
+        case Plasma::Types::TopEdge:
+            distance = pointer.y() - screenGeometry.top();
+            inFront = pointer.x() >= m_viewGeometry.left() && pointer.x() <= m_viewGeometry.right();
             break;
 
-        case Types::DodgeMaximized:
-            dodgeMaximized(wm->activeWindow());
+        case Plasma::Types::LeftEdge:
+            distance = pointer.x() - screenGeometry.left();
+            inFront = pointer.y() >= m_viewGeometry.top() && pointer.y() <= m_viewGeometry.bottom();
             break;
 
-        case Types::DodgeAllWindows:
-            dodgeWindows(wm->activeWindow());
+        case Plasma::Types::RightEdge:
+            distance = screenGeometry.right() - pointer.x();
+            inFront = pointer.y() >= m_viewGeometry.top() && pointer.y() <= m_viewGeometry.bottom();
             break;
 
         default:
             break;
     }
-}
 
-void VisibilityManager::setViewGeometry(const QRect &geometry)
-{
-    if (!m_latteView->containment())
-        return;
+    int interval{FarSamplingInterval};
 
-    m_viewGeometry = geometry;
+    if (!inFront || distance < 0 || !screenGeometry.contains(pointer)) {
+        cancelPredictedShow();
+        m_lastPointerDistance = -1;
+    } else {
+        if (m_lastPointerDistance >= 0 && elapsed > 0) {
+            //! pixels per ms towards the screen edge
+            const double velocity = static_cast<double>(m_lastPointerDistance - distance) / elapsed;
+
+            if (velocity <= 0) {
+                cancelPredictedShow();
+            } else if (distance / velocity <= m_timerShow.interval()) {
+                startPredictedShow();
+            }
+        }
 
-    if (m_mode == Types::AlwaysVisible && !m_latteView->inEditMode() && m_latteView->screen()) {
-        updateStrutsBasedOnLayoutsAndActivities();
-    }
-}
+        m_lastPointerDistance = distance;
 
-void VisibilityManager::setWindowOnActivities(QWindow &window, const QStringList &activities)
-{
-    wm->setWindowOnActivities(window, activities);
-}
+        //! the pointer is followed closely only inside the edge band of the view
+        if (distance <= SamplingBand) {
+            interval = NearSamplingInterval;
+        }
+    }
 
-void VisibilityManager::applyActivitiesToHiddenWindows(const QStringList &activities)
-{
-    if (edgeGhostWindow) {
-        wm->setWindowOnActivities(*edgeGhostWindow, activities);
+    if (m_pointerSamplingInterval != interval) {
+        m_pointerSamplingInterval = interval;
+        m_corona->pointerSampler()->request(this, interval);
     }
 }
 
-void VisibilityManager::dodgeActive(WindowId wid)
+void VisibilityManager::startPredictedShow()
 {
-    if (raiseTemporarily)
-        return;
-
-    //!don't send false raiseView signal when containing mouse
-    if (m_containsMouse) {
-        raiseView(true);
+    if (predictedShow || m_timerShow.isActive()) {
         return;
     }
 
-    auto winfo = wm->requestInfo(wid);
-
-    if (!winfo.isValid() || !winfo.isActive()) {
-        winfo = wm->requestInfo(wm->activeWindow());
+    predictedShow = true;
+    predictedShowReady = false;
+    m_timerShow.start();
+}
 
-        if (!winfo.isValid()) {
-            //! very rare case that window manager doesn't have any active window at all
-            raiseView(true);
-            return;
-        }
+void VisibilityManager::cancelPredictedShow()
+{
+    if (!predictedShow) {
+        return;
     }
 
-    //! don't send false raiseView signal when containing mouse, // Johan comment
-    //! I don't know why that wasn't winfo.wid() //active window, but just wid//the window that made the call
-    if (wm->isOnCurrentDesktop(winfo.wid()) && wm->isOnCurrentActivity(winfo.wid())) {
-        bool overlaps{intersects(winfo)};
-        raiseView(!overlaps);
-    }
+    predictedShow = false;
+    predictedShowReady = false;
+    m_timerShow.stop();
 }
 
-void VisibilityManager::dodgeMaximized(WindowId wid)
+void VisibilityManager::updateHiddenState()
 {
-    if (raiseTemporarily)
-        return;
-
-    //!don't send false raiseView signal when containing mouse
-    if (m_containsMouse) {
-        raiseView(true);
+    if (dragEnter)
         return;
-    }
 
-    auto winfo = wm->requestInfo(wid);
+    switch (m_mode) {
+        case Types::AutoHide:
+            raiseView(m_containsMouse);
+            break;
 
-    if (!winfo.isValid() || !winfo.isActive()) {
-        winfo = wm->requestInfo(wm->activeWindow());
+        case Types::DodgeActive:
+        case Types::DodgeMaximized:
+        case Types::DodgeAllWindows:
+            //!don't send false raiseView signal when containing mouse
+            if (m_containsMouse) {
+                raiseView(true);
+            } else {
+                m_windowsDodger->update();
+            }
 
-        if (!winfo.isValid()) {
-            //! very rare case that window manager doesn't have any active window at all
-            raiseView(true);
-            return;
-        }
-    }
+            break;
 
-    auto intersectsMaxVert = [&]() noexcept -> bool {
-        return ((winfo.isMaxVert()
-                 || (m_latteView->screen() && m_latteView->screen()->availableSize().height() <= winfo.geometry().height()))
-                && intersects(winfo));
-    };
-
-    auto intersectsMaxHoriz = [&]() noexcept -> bool {
-        return ((winfo.isMaxHoriz()
-                 || (m_latteView->screen() && m_latteView->screen()->availableSize().width() <= winfo.geometry().width()))
-                && intersects(winfo));
-    };
-
-    //! don't send false raiseView signal when containing mouse, // Johan comment
-    //! I don't know why that wasn't winfo.wid() //active window, but just wid//the window that made the call
-    if (wm->isOnCurrentDesktop(winfo.wid()) && wm->isOnCurrentActivity(winfo.wid())) {
-        bool overlapsMaximized{m_latteView->formFactor() == Plasma::Types::Vertical ? intersectsMaxHoriz() : intersectsMaxVert()};
-        raiseView(!overlapsMaximized);
+        default:
+            break;
     }
 }
 
-void VisibilityManager::dodgeWindows(WindowId wid)
+void VisibilityManager::setViewGeometry(const QRect &geometry)
 {
-    if (raiseTemporarily)
-        return;
-
-    if (windows.find(wid) == std::end(windows))
-        return;
-
-    //!don't send false raiseView signal when containing mouse
-    if (m_containsMouse) {
-        raiseView(true);
+    if (!m_latteView->containment())
         return;
-    }
 
-    windows[wid] = wm->requestInfo(wid);
-    auto &winfo = windows[wid];
+    m_viewGeometry = geometry;
 
-    if (!winfo.isValid() || !wm->isOnCurrentDesktop(wid) || !wm->isOnCurrentActivity(wid))
-        return;
+    updateWindowsDodger();
 
-    if (intersects(winfo))
-        raiseView(false);
-    else
-        m_timerCheckWindows.start();
+    if (m_mode == Types::AlwaysVisible && !m_latteView->inEditMode() && m_latteView->screen()) {
+        updateStrutsBasedOnLayoutsAndActivities();
+    }
 }
 
-void VisibilityManager::checkAllWindows()
+void VisibilityManager::updateWindowsDodger()
 {
-    if (raiseTemporarily)
-        return;
-
-    bool raise{true};
-    bool existsFaultyWindow{false};
-
-    for (const auto &winfo : windows) {
-        // <WindowId, WindowInfoWrap>
-        if (winfo.geometry() == QRect(0, 0, 0, 0)) {
-            existsFaultyWindow = true;
-        }
+    m_windowsDodger->setScreen(m_latteView->screen());
+    m_windowsDodger->setScreenGeometry(m_latteView->screenGeometry());
+    m_windowsDodger->setViewGeometry(m_viewGeometry);
+    m_windowsDodger->setFormFactor(m_latteView->formFactor());
+}
 
-        if (!winfo.isValid() || !wm->isOnCurrentDesktop(winfo.wid()) || !wm->isOnCurrentActivity(winfo.wid()))
-            continue;
+void VisibilityManager::setWindowOnActivities(QWindow &window, const QStringList &activities)
+{
+    wm->setWindowOnActivities(window, activities);
+}
 
-        if (winfo.isFullscreen()) {
-            raise = false;
-            break;
-        } else if (intersects(winfo)) {
-            raise = false;
-            break;
-        }
+void VisibilityManager::applyActivitiesToHiddenWindows(const QStringList &activities)
+{
+    if (edgeGhostWindow) {
+        wm->setWindowOnActivities(*edgeGhostWindow, activities);
     }
-
-    cleanupFaultyWindows();
-    raiseView(raise);
 }
 
-bool VisibilityManager::intersects(const WindowInfoWrap &winfo)
+void VisibilityManager::dodge(bool raise)
 {
-    return (!winfo.isMinimized()
-            && wm->isOnCurrentDesktop(winfo.wid())
-            && wm->isOnCurrentActivity(winfo.wid())
-            && winfo.geometry().intersects(m_viewGeometry)
-            && !winfo.isShaded());
+    if (raiseTemporarily) {
+        m_profiler.count(VisibilityProfiler::EventsFiltered);
+        return;
+    }
+
+    //!don't send false raiseView signal when containing mouse
+    raiseView(raise || m_containsMouse);
 }
 
 void VisibilityManager::saveConfig()
@@ -737,19 +736,6 @@ void VisibilityManager::viewEventManager(QEvent *ev)
     }
 }
 
-void VisibilityManager::cleanupFaultyWindows()
-{
-    foreach (auto key, windows.keys()) {
-        auto winfo = windows[key];
-
-        //! garbage windows removing
-        if (winfo.geometry() == QRect(0, 0, 0, 0)) {
-            //qDebug() << "Faulty Geometry ::: " << winfo.wid();
-            windows.remove(key);
-        }
-    }
-}
-
 //! Dynamic Background functions
 bool VisibilityManager::enabledDynamicBackground() const
 {
@@ -765,49 +751,14 @@ void VisibilityManager::setEnabledDynamicBackground(bool active)
     enabledDynamicBackgroundFlag = active;
 
     if (active) {
-        if (m_mode != Types::DodgeAllWindows) {
-            for (const auto &wid : wm->windows()) {
-                windows.insert(wid, wm->requestInfo(wid));
-            }
-        }
-
         connectionsDynBackground[0] = connect(m_latteView->corona(), &Plasma::Corona::availableScreenRectChanged,
-                                              this, &VisibilityManager::updateAvailableScreenGeometry);
-
-        connectionsDynBackground[1] = connect(wm, &WindowSystem::windowChanged, this, [&](WindowId wid) {
-            windows[wid] = wm->requestInfo(wid);
-            updateDynamicBackgroundWindowFlags();
-        });
-
-        connectionsDynBackground[2] = connect(wm, &WindowSystem::windowRemoved, this, [&](WindowId wid) {
-            windows.remove(wid);
-        });
-
-        connectionsDynBackground[3] = connect(wm, &WindowSystem::windowAdded, this, [&](WindowId wid) {
-            windows.insert(wid, wm->requestInfo(wid));
-            updateDynamicBackgroundWindowFlags();
-        });
-
-        connectionsDynBackground[4] = connect(wm, &WindowSystem::activeWindowChanged, this, [&](WindowId wid) {
-            if (windows.contains(lastActiveWindowWid)) {
-                windows[lastActiveWindowWid] = wm->requestInfo(lastActiveWindowWid);
-            }
-
-            windows[wid] = wm->requestInfo(wid);
-            lastActiveWindowWid = wid;
+                                              this, &VisibilityManager::updateDynamicBackgroundSubscription);
 
-            updateDynamicBackgroundWindowFlags();
-        });
-
-        connectionsDynBackground[5] = connect(wm, &WindowSystem::currentDesktopChanged, this, [&] {
-            updateDynamicBackgroundWindowFlags();
-        });
+        //! the windows are evaluated once for all views by the corona
+        connectionsDynBackground[1] = connect(m_corona->dynamicBackgroundTracker(), &DynamicBackgroundTracker::updated,
+                                              this, &VisibilityManager::updateDynamicBackgroundWindowFlags);
 
-        connectionsDynBackground[6] = connect(wm, &WindowSystem::currentActivityChanged, this, [&] {
-            updateDynamicBackgroundWindowFlags();
-        });
-
-        updateAvailableScreenGeometry();
+        updateDynamicBackgroundSubscription();
         updateDynamicBackgroundWindowFlags();
     } else {
         // clear mode
@@ -815,9 +766,7 @@ void VisibilityManager::setEnabledDynamicBackground(bool active)
             disconnect(c);
         }
 
-        if (m_mode != Types::DodgeAllWindows) {
-            windows.clear();
-        }
+        unsubscribeDynamicBackground();
 
        // ATTENTION: this was creating a crash under wayland environment through the blur effect
        // setExistsWindowMaximized(false);
@@ -875,94 +824,54 @@ void VisibilityManager::setTouchingWindowScheme(SchemeColors *scheme)
     emit touchingWindowSchemeChanged();
 }
 
-void VisibilityManager::updateAvailableScreenGeometry()
+void VisibilityManager::updateDynamicBackgroundSubscription()
 {
     if (!m_latteView || !m_latteView->containment()) {
         return;
     }
 
     int currentScrId = m_latteView->positioner()->currentScreenId();
-    QRect tempAvailableScreenGeometry = m_corona->availableScreenRectWithCriteria(currentScrId, {Types::AlwaysVisible}, {});
+    Plasma::Types::Location currentEdge = m_latteView->location();
 
-    if (tempAvailableScreenGeometry != availableScreenGeometry) {
-        availableScreenGeometry = tempAvailableScreenGeometry;
-
-        updateDynamicBackgroundWindowFlags();
+    if (currentScrId == dynamicBackgroundScreenId && currentEdge == dynamicBackgroundEdge) {
+        return;
     }
-}
 
-bool VisibilityManager::isMaximizedInCurrentScreen(const WindowInfoWrap &winfo)
-{
-    //! updated implementation to identify the screen that the maximized window is present
-    //! in order to avoid: https://bugs.kde.org/show_bug.cgi?id=397700
+    unsubscribeDynamicBackground();
 
-    if (winfo.isValid() && !winfo.isMinimized() && wm->isOnCurrentDesktop(winfo.wid()) && wm->isOnCurrentActivity(winfo.wid())) {
-        if (winfo.isMaximized() && availableScreenGeometry.contains(winfo.geometry().center())) {
-            return true;
-        }
-    }
+    dynamicBackgroundScreenId = currentScrId;
+    dynamicBackgroundEdge = currentEdge;
+    m_corona->dynamicBackgroundTracker()->subscribe(dynamicBackgroundScreenId, dynamicBackgroundEdge);
 
-    return false;
+    updateDynamicBackgroundWindowFlags();
 }
 
-bool VisibilityManager::isTouchingPanelEdge(const WindowInfoWrap &winfo)
+void VisibilityManager::unsubscribeDynamicBackground()
 {
-    if (winfo.isValid() && !winfo.isMinimized() && wm->isOnCurrentDesktop(winfo.wid()) && wm->isOnCurrentActivity(winfo.wid())) {
-        bool touchingPanelEdge{false};
-
-        QRect screenGeometry = m_latteView->screenGeometry();
-        bool inCurrentScreen{screenGeometry.contains(winfo.geometry().topLeft()) || screenGeometry.contains(winfo.geometry().bottomRight())};
-
-        if (inCurrentScreen) {
-            if (m_latteView->location() == Plasma::Types::TopEdge) {
-                touchingPanelEdge = (winfo.geometry().y() == availableScreenGeometry.y());
-            } else if (m_latteView->location() == Plasma::Types::BottomEdge) {
-                touchingPanelEdge = (winfo.geometry().bottom() == availableScreenGeometry.bottom());
-            } else if (m_latteView->location() == Plasma::Types::LeftEdge) {
-                touchingPanelEdge = (winfo.geometry().x() == availableScreenGeometry.x());
-            } else if (m_latteView->location() == Plasma::Types::RightEdge) {
-                touchingPanelEdge = (winfo.geometry().right() == availableScreenGeometry.right());
-            }
-        }
-
-        return touchingPanelEdge;
+    if (dynamicBackgroundScreenId < 0) {
+        return;
     }
 
-    return false;
+    m_corona->dynamicBackgroundTracker()->unsubscribe(dynamicBackgroundScreenId, dynamicBackgroundEdge);
+
+    dynamicBackgroundScreenId = -1;
+    dynamicBackgroundEdge = Plasma::Types::Floating;
 }
 
 void VisibilityManager::updateDynamicBackgroundWindowFlags()
 {
-    bool foundTouch{false};
-    bool foundMaximized{false};
-
-    //! the notification window is not sending a remove signal and creates windows of geometry (0x0 0,0),
-    //! maybe a garbage collector here is a good idea!!!
-    bool existsFaultyWindow{false};
-    WindowId maxWinId;
-    WindowId touchWinId;
-
-    for (const auto &winfo : windows) {
-        if (isMaximizedInCurrentScreen(winfo)) {
-            foundMaximized = true;
-            maxWinId = winfo.wid();
-        }
-
-        if (winfo.isActive() && (isTouchingPanelEdge(winfo) || (intersects(winfo)))) {
-            foundTouch = true;
-            touchWinId = winfo.wid();
-        }
+    if (dynamicBackgroundScreenId < 0) {
+        return;
+    }
 
-        if (!existsFaultyWindow && winfo.geometry() == QRect(0, 0, 0, 0)) {
-            existsFaultyWindow = true;
-        }
+    DynamicBackgroundTracker *tracker = m_corona->dynamicBackgroundTracker();
 
-        //qDebug() << "window geometry ::: " << winfo.geometry();
-    }
+    bool foundMaximized{tracker->existsWindowMaximized(dynamicBackgroundScreenId)};
 
-    if (existsFaultyWindow) {
-        cleanupFaultyWindows();
-    }
+    //! only the active window can be touching the view
+    const WindowInfoWrap &activeInfo = wm->windowInfo(wm->activeWindow());
+    bool foundTouch{activeInfo.isActive()
+                    && (tracker->existsWindowTouching(dynamicBackgroundScreenId, dynamicBackgroundEdge) || m_windowsDodger->intersects(activeInfo))};
 
     setExistsWindowMaximized(foundMaximized);
     setExistsWindowTouching(foundTouch);
@@ -971,9 +880,9 @@ void VisibilityManager::updateDynamicBackgroundWindowFlags()
 
     if (foundTouch) {
         //! first the touching one because that would mean it is active
-        setTouchingWindowScheme(wm->schemeForWindow(touchWinId));
+        setTouchingWindowScheme(wm->schemeForWindow(activeInfo.wid()));
     } else if (foundMaximized) {
-        setTouchingWindowScheme(wm->schemeForWindow(maxWinId));
+        setTouchingWindowScheme(wm->schemeForWindow(tracker->maximizedWindow(dynamicBackgroundScreenId)));
     } else {
         setTouchingWindowScheme(nullptr);
     }
@@ -1106,6 +1015,16 @@ bool VisibilityManager::activeWindowCanBeDragged()
     return false;
 }
 
+QVariantMap VisibilityManager::profilingData() const
+{
+    return m_profiler.data();
+}
+
+void VisibilityManager::resetProfilingData()
+{
+    m_profiler.reset();
+}
+
 //! END: VisibilityManager implementation
 
 }
@@ -22,6 +22,7 @@
 #define VISIBILITYMANAGER_H
 
 // local
+#include "visibilityprofiler.h"
 #include "../plasma/quick/containmentview.h"
 #include "../schemecolors.h"
 #include "../wm/abstractwindowinterface.h"
@@ -30,6 +31,7 @@
 
 // Qt
 #include <QObject>
+#include <QSet>
 #include <QTimer>
 
 // Plasma
@@ -40,6 +42,7 @@ class Corona;
 class View;
 namespace ViewPart {
 class ScreenEdgeGhostWindow;
+class WindowsDodger;
 }
 }
 
@@ -120,6 +123,10 @@ public slots:
     Q_INVOKABLE void requestMoveActiveWindow(int localX, int localY);
     Q_INVOKABLE bool activeWindowCanBeDragged();
 
+    //! visibility decisions counters and timings
+    Q_INVOKABLE QVariantMap profilingData() const;
+    Q_INVOKABLE void resetProfilingData();
+
 signals:
     void mustBeShown();
     void mustBeHide();
@@ -154,15 +161,18 @@ private:
     void raiseViewTemporarily();
     void updateHiddenState();
 
-    //! the notification window is not sending a remove signal and creates windows of geometry (0x0 0,0),
-    //! this is a garbage collector to collect such windows in order to not break the windows array validity.
-    void cleanupFaultyWindows();
+    //! Predicted show, pointer velocity towards the view edge
+    void updatePointerSampling();
+    void samplePointer(const QPoint &pointer, qint64 elapsed);
+    void startPredictedShow();
+    void cancelPredictedShow();
 
     //! Dynamic Background Feature
     void setExistsWindowMaximized(bool windowMaximized);
     void setExistsWindowTouching(bool windowTouching);
     void setTouchingWindowScheme(SchemeColors *scheme);
-    void updateAvailableScreenGeometry();
+    void updateDynamicBackgroundSubscription();
+    void unsubscribeDynamicBackground();
     void updateDynamicBackgroundWindowFlags();
 
     //! KWin Edges Support functions
@@ -171,16 +181,12 @@ private:
     void updateKWinEdgesSupport();
 
     void setViewGeometry(const QRect &rect);
+    //! the windows dodger follows the view geometry and its screen
+    void updateWindowsDodger();
 
     void windowAdded(WindowId id);
-    void dodgeActive(WindowId id);
-    void dodgeMaximized(WindowId id);
-    void dodgeWindows(WindowId id);
-    void checkAllWindows();
-
-    bool intersects(const WindowInfoWrap &winfo);
-    bool isMaximizedInCurrentScreen(const WindowInfoWrap &winfo);
-    bool isTouchingPanelEdge(const WindowInfoWrap &winfo);
+    //! the dodge modes decision of the windows dodger
+    void dodge(bool raise);
 
     void updateStrutsBasedOnLayoutsAndActivities();
     void viewEventManager(QEvent *ev);
@@ -188,12 +194,10 @@ private:
 private:
     AbstractWindowInterface *wm;
     Types::Visibility m_mode{Types::None};
-    std::array<QMetaObject::Connection, 5> connections;
-    QMap<WindowId, WindowInfoWrap> windows;
+    std::array<QMetaObject::Connection, 6> connections;
 
     QTimer m_timerShow;
     QTimer m_timerHide;
-    QTimer m_timerCheckWindows;
     QTimer m_timerStartUp;
     QRect m_viewGeometry;
     bool m_isHidden{false};
@@ -205,13 +209,31 @@ private:
     bool raiseOnActivityChange{false};
     bool hideNow{false};
 
+    //! while the view is hidden the shared pointer sampler watches the pointer
+    //! slowly and follows it closely only inside the edge band of the view.
+    //! When it is predicted to reach the view edge within the show interval
+    //! the show timer starts early.
+    //! The view is still shown only when the pointer really reaches it.
+    static const int FarSamplingInterval{50};
+    static const int NearSamplingInterval{7}; //! ~144Hz
+    static const int SamplingBand{300};
+    bool predictedShow{false};
+    bool predictedShowReady{false};
+    int m_lastPointerDistance{-1};
+    int m_pointerSamplingInterval{0};
+    QMetaObject::Connection m_pointerSamplingConnection;
+
+    VisibilityProfiler m_profiler;
+
+    WindowsDodger *m_windowsDodger{nullptr};
+
     //! Dynamic Background flags and needed information
     bool enabledDynamicBackgroundFlag{false};
     bool windowIsTouchingFlag{false};
     bool windowIsMaximizedFlag{false};
-    QRect availableScreenGeometry;
-    std::array<QMetaObject::Connection, 7> connectionsDynBackground;
-    WindowId lastActiveWindowWid;
+    int dynamicBackgroundScreenId{-1};
+    Plasma::Types::Location dynamicBackgroundEdge{Plasma::Types::Floating};
+    std::array<QMetaObject::Connection, 2> connectionsDynBackground;
     SchemeColors *touchingScheme{nullptr};
 
 
@@ -222,7 +244,6 @@ private:
 
     Latte::Corona *m_corona{nullptr};
     Latte::View *m_latteView{nullptr};
-
 };
 
 }
@@ -0,0 +1,148 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "visibilityprofiler.h"
+
+// Qt
+#include <QVariantList>
+
+namespace Latte {
+namespace ViewPart {
+
+namespace {
+const std::array<qint64, 7> BucketBoundsUsecs{{10, 50, 100, 500, 1000, 5000, 10000}};
+
+const std::array<const char *, VisibilityProfiler::CountersCount> CounterNames{{
+        "eventsReceived",
+        "eventsFiltered",
+        "windowInfoLookups",
+        "windowScans",
+        "raiseDecisions",
+        "hideDecisions",
+        "pointerSamples"
+    }};
+
+const std::array<const char *, VisibilityProfiler::HandlersCount> HandlerNames{{
+        "dodgeActive",
+        "dodgeMaximized",
+        "dodgeWindows",
+        "checkAllWindows",
+        "pointerSampling"
+    }};
+}
+
+VisibilityProfiler::Timing::Timing(VisibilityProfiler *profiler, Handler handler)
+    : m_profiler(profiler),
+      m_handler(handler)
+{
+    m_timer.start();
+}
+
+VisibilityProfiler::Timing::~Timing()
+{
+    m_profiler->addTiming(m_handler, m_timer.nsecsElapsed());
+}
+
+VisibilityProfiler::VisibilityProfiler()
+{
+    reset();
+}
+
+void VisibilityProfiler::count(Counter counter, int value)
+{
+    m_counters[counter] += value;
+}
+
+void VisibilityProfiler::addTiming(Handler handler, qint64 nsecs)
+{
+    HandlerStats &stats = m_handlers[handler];
+
+    stats.calls++;
+    stats.totalNsecs += nsecs;
+    stats.maxNsecs = qMax(stats.maxNsecs, nsecs);
+
+    const qint64 usecs = nsecs / 1000;
+    int bucket = 0;
+
+    while (bucket < static_cast<int>(BucketBoundsUsecs.size()) && usecs >= BucketBoundsUsecs[bucket]) {
+        ++bucket;
+    }
+
+    stats.buckets[bucket]++;
+}
+
+void VisibilityProfiler::reset()
+{
+    m_counters.fill(0);
+
+    for (auto &stats : m_handlers) {
+        stats = HandlerStats();
+        stats.buckets.fill(0);
+    }
+
+    m_since.start();
+}
+
+QVariantMap VisibilityProfiler::data() const
+{
+    QVariantMap counters;
+
+    for (int i = 0; i < CountersCount; ++i) {
+        counters[CounterNames[i]] = m_counters[i];
+    }
+
+    QVariantMap handlers;
+
+    for (int i = 0; i < HandlersCount; ++i) {
+        const HandlerStats &stats = m_handlers[i];
+
+        QVariantList histogram;
+
+        for (const auto &bucket : stats.buckets) {
+            histogram << bucket;
+        }
+
+        QVariantMap handler;
+        handler["calls"] = stats.calls;
+        handler["totalUsecs"] = stats.totalNsecs / 1000;
+        handler["averageUsecs"] = stats.calls > 0 ? static_cast<qint64>(stats.totalNsecs / stats.calls / 1000) : 0;
+        handler["maxUsecs"] = stats.maxNsecs / 1000;
+        handler["histogram"] = histogram;
+
+        handlers[HandlerNames[i]] = handler;
+    }
+
+    QVariantList bounds;
+
+    for (const auto &bound : BucketBoundsUsecs) {
+        bounds << bound;
+    }
+
+    QVariantMap data;
+    data["seconds"] = m_since.elapsed() / 1000;
+    data["counters"] = counters;
+    data["handlers"] = handlers;
+    //! upper bounds of the histograms buckets, the last bucket has no bound
+    data["histogramUsecs"] = bounds;
+
+    return data;
+}
+
+}
+}
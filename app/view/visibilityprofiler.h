@@ -0,0 +1,104 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef VISIBILITYPROFILER_H
+#define VISIBILITYPROFILER_H
+
+// C++
+#include <array>
+
+// Qt
+#include <QElapsedTimer>
+#include <QVariantMap>
+
+namespace Latte {
+namespace ViewPart {
+
+//! Counters and timing histograms of the visibility decisions of a view.
+//! They are always collected, that way the views that are burning cpu
+//! can be identified in production through D-Bus or the debug window.
+class VisibilityProfiler
+{
+public:
+    enum Counter
+    {
+        EventsReceived = 0,
+        EventsFiltered,
+        WindowInfoLookups,
+        WindowScans,
+        RaiseDecisions,
+        HideDecisions,
+        PointerSamples,
+        CountersCount
+    };
+
+    enum Handler
+    {
+        DodgeActiveHandler = 0,
+        DodgeMaximizedHandler,
+        DodgeWindowsHandler,
+        CheckAllWindowsHandler,
+        PointerSamplingHandler,
+        HandlersCount
+    };
+
+    //! measures the time spent in a handler until it goes out of scope
+    class Timing
+    {
+    public:
+        Timing(VisibilityProfiler *profiler, Handler handler);
+        ~Timing();
+
+    private:
+        VisibilityProfiler *m_profiler{nullptr};
+        Handler m_handler;
+        QElapsedTimer m_timer;
+    };
+
+    VisibilityProfiler();
+
+    void count(Counter counter, int value = 1);
+    void addTiming(Handler handler, qint64 nsecs);
+
+    void reset();
+
+    //! counters, handler timings in microseconds and their histograms
+    QVariantMap data() const;
+
+private:
+    //! histogram upper bounds in microseconds, the last bucket has no bound
+    static const int BucketsCount{8};
+
+    struct HandlerStats {
+        quint64 calls{0};
+        qint64 totalNsecs{0};
+        qint64 maxNsecs{0};
+        std::array<quint64, BucketsCount> buckets;
+    };
+
+    std::array<quint64, CountersCount> m_counters;
+    std::array<HandlerStats, HandlersCount> m_handlers;
+
+    QElapsedTimer m_since;
+};
+
+}
+}
+
+#endif
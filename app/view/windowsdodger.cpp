@@ -0,0 +1,311 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "windowsdodger.h"
+
+namespace Latte {
+namespace ViewPart {
+
+WindowsDodger::WindowsDodger(AbstractWindowInterface *wm, VisibilityProfiler *profiler, QObject *parent)
+    : QObject(parent),
+      m_wm(wm),
+      m_profiler(profiler)
+{
+}
+
+WindowsDodger::~WindowsDodger()
+{
+    m_wm->removeInterest(this);
+}
+
+Types::Visibility WindowsDodger::mode() const
+{
+    return m_mode;
+}
+
+void WindowsDodger::setMode(Types::Visibility mode)
+{
+    if (m_mode == mode) {
+        return;
+    }
+
+    for (auto &c : m_connections) {
+        disconnect(c);
+    }
+
+    m_occupyingWindows.clear();
+    m_mode = mode;
+
+    //! the window states must be available before the dodge modes are evaluated
+    updateWindowsInterest();
+
+    switch (m_mode) {
+        case Types::DodgeActive:
+            m_connections[0] = connect(m_wm, &AbstractWindowInterface::activeWindowChanged
+            , this, [&](WindowId wid) {
+                m_profiler->count(VisibilityProfiler::EventsReceived);
+                dodgeActive(wid);
+            });
+            m_connections[1] = connect(m_wm, &AbstractWindowInterface::windowsChanged
+            , this, [&](const QHash<WindowId, AbstractWindowInterface::ChangedProperties> &changes) {
+                m_profiler->count(VisibilityProfiler::EventsReceived);
+
+                //! only the active window changes can alter the view state
+                if (changes.contains(m_wm->activeWindow())) {
+                    dodgeActive(m_wm->activeWindow());
+                } else {
+                    m_profiler->count(VisibilityProfiler::EventsFiltered);
+                }
+            });
+            break;
+
+        case Types::DodgeMaximized:
+            m_connections[0] = connect(m_wm, &AbstractWindowInterface::activeWindowChanged
+            , this, [&](WindowId wid) {
+                m_profiler->count(VisibilityProfiler::EventsReceived);
+                dodgeMaximized(wid);
+            });
+            m_connections[1] = connect(m_wm, &AbstractWindowInterface::windowsChanged
+            , this, [&](const QHash<WindowId, AbstractWindowInterface::ChangedProperties> &changes) {
+                m_profiler->count(VisibilityProfiler::EventsReceived);
+
+                //! only the active window changes can alter the view state
+                if (changes.contains(m_wm->activeWindow())) {
+                    dodgeMaximized(m_wm->activeWindow());
+                } else {
+                    m_profiler->count(VisibilityProfiler::EventsFiltered);
+                }
+            });
+            break;
+
+        case Types::DodgeAllWindows:
+            m_connections[0] = connect(m_wm, &AbstractWindowInterface::windowsChanged
+            , this, [&](const QHash<WindowId, AbstractWindowInterface::ChangedProperties> &changes) {
+                m_profiler->count(VisibilityProfiler::EventsReceived);
+                dodgeWindows(changes.keys());
+            });
+            m_connections[1] = connect(m_wm, &AbstractWindowInterface::windowRemoved
+            , this, [&](WindowId wid) {
+                m_profiler->count(VisibilityProfiler::EventsReceived);
+                dodgeWindows({wid});
+            });
+            m_connections[2] = connect(m_wm, &AbstractWindowInterface::windowAdded
+            , this, [&](WindowId wid) {
+                m_profiler->count(VisibilityProfiler::EventsReceived);
+                dodgeWindows({wid});
+            });
+            m_connections[3] = connect(m_wm, &AbstractWindowInterface::currentDesktopChanged
+            , this, [&]() {
+                m_profiler->count(VisibilityProfiler::EventsReceived);
+                checkAllWindows();
+            });
+            break;
+
+        default:
+            break;
+    }
+}
+
+void WindowsDodger::setViewGeometry(const QRect &geometry)
+{
+    if (m_viewGeometry == geometry) {
+        return;
+    }
+
+    m_viewGeometry = geometry;
+
+    if (m_mode == Types::DodgeAllWindows) {
+        updateOccupyingWindows();
+    }
+}
+
+void WindowsDodger::setFormFactor(Plasma::Types::FormFactor formFactor)
+{
+    m_formFactor = formFactor;
+}
+
+void WindowsDodger::setScreenGeometry(const QRect &geometry)
+{
+    if (m_screenGeometry == geometry) {
+        return;
+    }
+
+    m_screenGeometry = geometry;
+    updateWindowsInterest();
+}
+
+void WindowsDodger::setScreen(QScreen *screen)
+{
+    m_screen = screen;
+}
+
+void WindowsDodger::update()
+{
+    switch (m_mode) {
+        case Types::DodgeActive:
+            dodgeActive(m_wm->activeWindow());
+            break;
+
+        case Types::DodgeMaximized:
+            dodgeMaximized(m_wm->activeWindow());
+            break;
+
+        case Types::DodgeAllWindows:
+            checkAllWindows();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void WindowsDodger::updateWindowsInterest()
+{
+    //! only the dodge modes need the windows of the view screen
+    if (m_mode == Types::DodgeActive || m_mode == Types::DodgeMaximized || m_mode == Types::DodgeAllWindows) {
+        m_wm->setInterest(this, m_screenGeometry);
+    } else {
+        m_wm->removeInterest(this);
+    }
+}
+
+void WindowsDodger::dodgeActive(WindowId wid)
+{
+    VisibilityProfiler::Timing timing(m_profiler, VisibilityProfiler::DodgeActiveHandler);
+
+    WindowId activeWid = m_wm->windowInfo(wid).isActive() ? wid : m_wm->activeWindow();
+    const WindowInfoWrap &winfo = m_wm->windowInfo(activeWid);
+    m_profiler->count(VisibilityProfiler::WindowInfoLookups, 2);
+
+    if (!winfo.isValid()) {
+        //! very rare case that window manager doesn't have any active window at all
+        emit raiseRequested(true);
+        return;
+    }
+
+    if (m_wm->inCurrentDesktop(winfo) && m_wm->inCurrentActivity(winfo)) {
+        emit raiseRequested(!intersects(winfo));
+    }
+}
+
+void WindowsDodger::dodgeMaximized(WindowId wid)
+{
+    VisibilityProfiler::Timing timing(m_profiler, VisibilityProfiler::DodgeMaximizedHandler);
+
+    WindowId activeWid = m_wm->windowInfo(wid).isActive() ? wid : m_wm->activeWindow();
+    const WindowInfoWrap &winfo = m_wm->windowInfo(activeWid);
+    m_profiler->count(VisibilityProfiler::WindowInfoLookups, 2);
+
+    if (!winfo.isValid()) {
+        //! very rare case that window manager doesn't have any active window at all
+        emit raiseRequested(true);
+        return;
+    }
+
+    auto intersectsMaxVert = [&]() noexcept -> bool {
+        return ((winfo.isMaxVert()
+                 || (m_screen && m_screen->availableSize().height() <= winfo.geometry().height()))
+                && intersects(winfo));
+    };
+
+    auto intersectsMaxHoriz = [&]() noexcept -> bool {
+        return ((winfo.isMaxHoriz()
+                 || (m_screen && m_screen->availableSize().width() <= winfo.geometry().width()))
+                && intersects(winfo));
+    };
+
+    if (m_wm->inCurrentDesktop(winfo) && m_wm->inCurrentActivity(winfo)) {
+        bool overlapsMaximized{m_formFactor == Plasma::Types::Vertical ? intersectsMaxHoriz() : intersectsMaxVert()};
+        emit raiseRequested(!overlapsMaximized);
+    }
+}
+
+void WindowsDodger::dodgeWindows(const QList<WindowId> &wids)
+{
+    VisibilityProfiler::Timing timing(m_profiler, VisibilityProfiler::DodgeWindowsHandler);
+
+    //! only the changed windows can enter or leave the view area
+    for (const auto &wid : wids) {
+        updateOccupyingWindow(wid);
+    }
+
+    emit raiseRequested(m_occupyingWindows.isEmpty());
+}
+
+void WindowsDodger::checkAllWindows()
+{
+    VisibilityProfiler::Timing timing(m_profiler, VisibilityProfiler::CheckAllWindowsHandler);
+
+    updateOccupyingWindows();
+
+    emit raiseRequested(m_occupyingWindows.isEmpty());
+}
+
+void WindowsDodger::updateOccupyingWindow(WindowId wid)
+{
+    //! removed windows are not found in the window states cache and are invalid
+    const WindowInfoWrap &winfo = m_wm->windowInfo(wid);
+    m_profiler->count(VisibilityProfiler::WindowInfoLookups);
+
+    if (occupiesView(winfo)) {
+        m_occupyingWindows.insert(wid);
+    } else {
+        m_occupyingWindows.remove(wid);
+    }
+}
+
+void WindowsDodger::updateOccupyingWindows()
+{
+    m_profiler->count(VisibilityProfiler::WindowScans);
+    m_occupyingWindows.clear();
+
+    for (const auto &wid : m_wm->fullscreenWindows()) {
+        updateOccupyingWindow(wid);
+    }
+
+    //! only the windows overlapping the view strip need to be checked
+    for (const auto &wid : m_wm->windowsIn(m_viewGeometry)) {
+        updateOccupyingWindow(wid);
+    }
+}
+
+bool WindowsDodger::occupiesView(const WindowInfoWrap &winfo) const
+{
+    if (!winfo.isValid()) {
+        return false;
+    }
+
+    if (winfo.isFullscreen() && m_wm->inCurrentDesktop(winfo) && m_wm->inCurrentActivity(winfo)) {
+        return true;
+    }
+
+    return intersects(winfo);
+}
+
+bool WindowsDodger::intersects(const WindowInfoWrap &winfo) const
+{
+    return (!winfo.isMinimized()
+            && m_wm->inCurrentDesktop(winfo)
+            && m_wm->inCurrentActivity(winfo)
+            && winfo.geometry().intersects(m_viewGeometry)
+            && !winfo.isShaded());
+}
+
+}
+}
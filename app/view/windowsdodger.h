@@ -0,0 +1,112 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WINDOWSDODGER_H
+#define WINDOWSDODGER_H
+
+// local
+#include "visibilityprofiler.h"
+#include "../wm/abstractwindowinterface.h"
+#include "../wm/windowinfowrap.h"
+#include "../../liblatte2/types.h"
+
+// C++
+#include <array>
+
+// Qt
+#include <QObject>
+#include <QPointer>
+#include <QRect>
+#include <QScreen>
+#include <QSet>
+
+// Plasma
+#include <Plasma>
+
+namespace Latte {
+namespace ViewPart {
+
+//! The windows part of the dodge visibility modes. It follows the windows of the
+//! view screen and decides whether they leave the view visible. It knows only the
+//! view geometry and its screen, that way the same decisions can be driven by the
+//! synthetic window tracking without any view.
+class WindowsDodger : public QObject
+{
+    Q_OBJECT
+
+public:
+    WindowsDodger(AbstractWindowInterface *wm, VisibilityProfiler *profiler, QObject *parent = nullptr);
+    ~WindowsDodger() override;
+
+    Types::Visibility mode() const;
+    //! only the dodge modes follow the windows, the rest are ignored
+    void setMode(Types::Visibility mode);
+
+    void setViewGeometry(const QRect &geometry);
+    void setFormFactor(Plasma::Types::FormFactor formFactor);
+
+    //! the screen geometry is the windows interest region, the screen itself
+    //! is used for the available size when it is known
+    void setScreenGeometry(const QRect &geometry);
+    void setScreen(QScreen *screen);
+
+    //! the current windows are evaluated again
+    void update();
+
+    bool intersects(const WindowInfoWrap &winfo) const;
+
+signals:
+    //! delivered for every evaluation, the view must be raised when no window
+    //! is overlapping it
+    void raiseRequested(bool raise);
+
+private:
+    void dodgeActive(WindowId wid);
+    void dodgeMaximized(WindowId wid);
+    void dodgeWindows(const QList<WindowId> &wids);
+    void checkAllWindows();
+    void updateOccupyingWindow(WindowId wid);
+    void updateOccupyingWindows();
+
+    bool occupiesView(const WindowInfoWrap &winfo) const;
+
+    void updateWindowsInterest();
+
+private:
+    Types::Visibility m_mode{Types::None};
+    Plasma::Types::FormFactor m_formFactor{Plasma::Types::Horizontal};
+
+    QRect m_viewGeometry;
+    QRect m_screenGeometry;
+    QPointer<QScreen> m_screen;
+
+    //! DodgeAllWindows, windows that currently overlap the view, they are
+    //! updated only when a window enters or leaves the view area
+    QSet<WindowId> m_occupyingWindows;
+
+    std::array<QMetaObject::Connection, 4> m_connections;
+
+    AbstractWindowInterface *m_wm{nullptr};
+    VisibilityProfiler *m_profiler{nullptr};
+};
+
+}
+}
+
+#endif
@@ -21,8 +21,7 @@
 #include "abstractwindowinterface.h"
 
 // local
-#include "xwindowinterface.h"
-#include "waylandinterface.h"
+#include "../schemesregistry.h"
 
 // Qt
 #include <QObject>
@@ -30,7 +29,6 @@
 #include <QQuickWindow>
 
 // KDE
-#include <KDirWatch>
 #include <KWindowSystem>
 
 namespace Latte {
@@ -42,29 +40,51 @@ AbstractWindowInterface::AbstractWindowInterface(QObject *parent)
 
     connect(this, &AbstractWindowInterface::windowRemoved, this, [&](WindowId wid) {
         m_windowScheme.remove(wid);
+        m_pendingChanges.remove(wid);
     });
 
-    //! track for changing default scheme
-    QString kdeSettingsFile = QDir::homePath() + "/.config/kdeglobals";
+    connect(this, &AbstractWindowInterface::currentActivityChanged, this, [&]() {
+        m_currentActivityId = m_activities ? activityId(m_activities->currentActivity()) : -1;
+    });
 
-    KDirWatch::self()->addFile(kdeSettingsFile);
+    //! one flush per frame
+    m_windowChangesTimer.setInterval(16);
+    m_windowChangesTimer.setSingleShot(true);
+    connect(&m_windowChangesTimer, &QTimer::timeout, this, &AbstractWindowInterface::flushWindowChanges);
 
-    connect(KDirWatch::self(), &KDirWatch::dirty, this, [ &, kdeSettingsFile](const QString & path) {
-        if (path == kdeSettingsFile) {
-            this->updateDefaultScheme();
+    //! the window states cache must be updated before any view is informed,
+    //! so these connections must be the first ones for these signals
+    connect(this, &AbstractWindowInterface::windowAdded, this, [&](WindowId wid) {
+        //! backends may have already requested the window state in a batch
+        if (hasInterest() && !hasWindowInfo(wid)) {
+            updateWindowInfo(wid);
         }
     });
+    connect(this, &AbstractWindowInterface::windowRemoved, this, &AbstractWindowInterface::removeWindowInfo);
+
+    connect(this, &AbstractWindowInterface::activeWindowChanged, this, [&](WindowId wid) {
+        if (!hasInterest()) {
+            m_lastActiveWindow = wid;
+            return;
+        }
 
-    connect(KDirWatch::self(), &KDirWatch::created, this, [ &, kdeSettingsFile](const QString & path) {
-        if (path == kdeSettingsFile) {
-            this->updateDefaultScheme();
+        if (hasWindowInfo(m_lastActiveWindow) && m_lastActiveWindow != wid) {
+            updateWindowsInfo({m_lastActiveWindow, wid});
+        } else {
+            updateWindowInfo(wid);
         }
+
+        m_lastActiveWindow = wid;
     });
+
+    //! track for changing default scheme
+    connect(SchemesRegistry::self(), &SchemesRegistry::kdeglobalsChanged, this, &AbstractWindowInterface::updateDefaultScheme);
 }
 
 AbstractWindowInterface::~AbstractWindowInterface()
 {
     m_windowScheme.clear();
+    m_classScheme.clear();
     //! it is just a reference to a real scheme file
     m_schemes.take("kdeglobals");
     qDeleteAll(m_schemes);
@@ -73,15 +93,412 @@ AbstractWindowInterface::~AbstractWindowInterface()
 
 void AbstractWindowInterface::addView(WindowId wid)
 {
-    m_views.push_back(wid);
+    m_views.insert(wid);
 }
 
 void AbstractWindowInterface::removeView(WindowId wid)
 {
-    auto it = std::find(m_views.begin(), m_views.end(), wid);
+    m_views.remove(wid);
+}
+
+//! Window states cache
+bool AbstractWindowInterface::hasWindowInfo(WindowId wid) const
+{
+    return m_windowsInfoIndex.contains(wid);
+}
+
+const WindowInfoWrap &AbstractWindowInterface::windowInfo(WindowId wid) const
+{
+    static const WindowInfoWrap invalidInfo;
+
+    const int pos = m_windowsInfoIndex.indexOf(wid);
+
+    if (pos < 0) {
+        return invalidInfo;
+    }
+
+    return m_windowsInfo[pos];
+}
+
+const std::vector<WindowInfoWrap> &AbstractWindowInterface::windowsInfo() const
+{
+    return m_windowsInfo;
+}
+
+int AbstractWindowInterface::activityId(const QString &activity) const
+{
+    auto it = m_activitiesIds.constFind(activity);
+
+    if (it != m_activitiesIds.constEnd()) {
+        return *it;
+    }
+
+    const int id = m_activitiesIds.count();
+    m_activitiesIds[activity] = id;
+
+    return id;
+}
+
+QBitArray AbstractWindowInterface::activitiesMask(const QStringList &activities) const
+{
+    QBitArray mask;
+
+    for (const auto &activity : activities) {
+        const int id = activityId(activity);
+
+        if (id >= mask.size()) {
+            mask.resize(id + 1);
+        }
+
+        mask.setBit(id);
+    }
+
+    return mask;
+}
+
+int AbstractWindowInterface::currentDesktop() const
+{
+    return KWindowSystem::currentDesktop();
+}
+
+QString AbstractWindowInterface::currentActivity() const
+{
+    return m_activities ? m_activities->currentActivity() : QString();
+}
+
+bool AbstractWindowInterface::inCurrentDesktop(const WindowInfoWrap &winfo) const
+{
+    return winfo.isOnDesktop(currentDesktop());
+}
+
+bool AbstractWindowInterface::inCurrentActivity(const WindowInfoWrap &winfo) const
+{
+    if (m_currentActivityId < 0 && m_activities) {
+        m_currentActivityId = activityId(m_activities->currentActivity());
+    }
+
+    return winfo.isOnActivity(m_currentActivityId);
+}
+
+void AbstractWindowInterface::setInterest(const QObject *consumer, const QRegion &region)
+{
+    if (region.isEmpty()) {
+        removeInterest(consumer);
+        return;
+    }
+
+    auto interest = m_interests.find(consumer);
+
+    if (interest != m_interests.end() && interest.value() == region) {
+        return;
+    }
+
+    if (interest == m_interests.end()) {
+        connect(consumer, &QObject::destroyed, this, [&, consumer]() {
+            removeInterest(consumer);
+        });
+    }
+
+    const bool hadInterest = hasInterest();
+
+    m_interests[consumer] = region;
+    updateInterestRegion();
+
+    if (!hadInterest) {
+        interestGained();
+        return;
+    }
+
+    //! skipped windows that entered the interest region are requested again
+    std::vector<WindowId> staleWids;
+
+    for (const auto &wid : m_staleWindows) {
+        if (isInteresting(windowInfo(wid).geometry())) {
+            staleWids.push_back(wid);
+        }
+    }
+
+    if (!staleWids.empty()) {
+        updateWindowsInfo(staleWids);
+    }
+}
+
+void AbstractWindowInterface::removeInterest(const QObject *consumer)
+{
+    if (m_interests.remove(consumer) == 0) {
+        return;
+    }
+
+    disconnect(consumer, &QObject::destroyed, this, nullptr);
+    updateInterestRegion();
+}
+
+bool AbstractWindowInterface::hasInterest() const
+{
+    return !m_interestRegion.isEmpty();
+}
+
+bool AbstractWindowInterface::isInteresting(const QRect &geometry) const
+{
+    return m_interestRegion.intersects(geometry);
+}
+
+void AbstractWindowInterface::updateInterestRegion()
+{
+    m_interestRegion = QRegion();
+
+    for (const auto &region : m_interests) {
+        m_interestRegion += region;
+    }
+}
+
+void AbstractWindowInterface::interestGained()
+{
+    //! window states were not maintained while nobody was interested in them
+    m_staleWindows.clear();
+    updateWindowsInfo(windows());
+
+    if (m_lastActiveWindow > 0) {
+        updateWindowInfo(m_lastActiveWindow);
+    }
+}
+
+QVector<WindowId> AbstractWindowInterface::windowsIn(const QRect &area) const
+{
+    return m_geometryIndex.windowsIn(area);
+}
+
+const QList<WindowId> &AbstractWindowInterface::fullscreenWindows() const
+{
+    return m_fullscreenWindows;
+}
+
+int AbstractWindowInterface::windowChangesInterval() const
+{
+    return m_windowChangesTimer.interval();
+}
+
+void AbstractWindowInterface::setWindowChangesInterval(int msec)
+{
+    m_windowChangesTimer.setInterval(qMax(0, msec));
+}
+
+void AbstractWindowInterface::queueWindowChanged(WindowId wid, ChangedProperties properties)
+{
+    m_pendingChanges[wid] |= properties;
+
+    //! the timer is not restarted, that way a storm of events is flushed
+    //! at most once per interval
+    if (!m_windowChangesTimer.isActive()) {
+        m_windowChangesTimer.start();
+    }
+}
+
+void AbstractWindowInterface::flushWindowChanges()
+{
+    if (m_pendingChanges.isEmpty()) {
+        return;
+    }
+
+    //! changes that are queued while the states are requested wait for the next flush
+    QHash<WindowId, ChangedProperties> changes;
+    changes.swap(m_pendingChanges);
+
+    //! nobody is interested, all the states are requested when that changes
+    if (!hasInterest()) {
+        return;
+    }
+
+    //! windows that were only moved or resized need just their geometry,
+    //! window drags are by far the most frequent window events
+    std::vector<WindowId> infoWids;
+    std::vector<WindowId> geometryWids;
+
+    //! windows whose only change is their state, they are not delivered
+    //! when none of the tracked states changed
+    QHash<WindowId, WindowInfoWrap> stateOnlyWindows;
+
+    for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+        const bool stored = hasWindowInfo(it.key()) && !windowInfo(it.key()).isPlasmaDesktop();
+        const bool outside = stored && !isInteresting(windowInfo(it.key()).geometry());
+
+        if (outside && !(it.value() & ActiveProperty)) {
+            //! windows out of the interest region are followed only by their geometry,
+            //! the rest of their changes are requested when they enter the region
+            if (it.value() != GeometryProperty) {
+                m_staleWindows.insert(it.key());
+            }
+
+            if (it.value() & GeometryProperty) {
+                geometryWids.push_back(it.key());
+            }
+        } else if (stored && it.value() == GeometryProperty) {
+            geometryWids.push_back(it.key());
+        } else {
+            if (stored && it.value() == StateProperty) {
+                stateOnlyWindows[it.key()] = windowInfo(it.key());
+            }
+
+            infoWids.push_back(it.key());
+        }
+    }
+
+    if (!geometryWids.empty()) {
+        updateWindowsGeometry(geometryWids);
+    }
+
+    if (!infoWids.empty()) {
+        updateWindowsInfo(infoWids);
+    }
+
+    for (auto it = stateOnlyWindows.constBegin(); it != stateOnlyWindows.constEnd(); ++it) {
+        if (hasWindowInfo(it.key()) && sameStates(it.value(), windowInfo(it.key()))) {
+            changes.remove(it.key());
+        }
+    }
+
+    if (!changes.isEmpty()) {
+        emit windowsChanged(changes);
+    }
+}
+
+bool AbstractWindowInterface::sameStates(const WindowInfoWrap &winfo1, const WindowInfoWrap &winfo2)
+{
+    return winfo1.isMinimized() == winfo2.isMinimized()
+           && winfo1.isMaxVert() == winfo2.isMaxVert()
+           && winfo1.isMaxHoriz() == winfo2.isMaxHoriz()
+           && winfo1.isFullscreen() == winfo2.isFullscreen()
+           && winfo1.isShaded() == winfo2.isShaded()
+           && winfo1.isKeepAbove() == winfo2.isKeepAbove()
+           && winfo1.hasSkipTaskbar() == winfo2.hasSkipTaskbar()
+           && winfo1.geometry() == winfo2.geometry();
+}
+
+std::vector<WindowInfoWrap> AbstractWindowInterface::requestInfos(const std::vector<WindowId> &wids) const
+{
+    std::vector<WindowInfoWrap> infos;
+    infos.reserve(wids.size());
+
+    for (const auto &wid : wids) {
+        infos.push_back(requestInfo(wid));
+    }
+
+    return infos;
+}
+
+std::vector<QRect> AbstractWindowInterface::requestGeometries(const std::vector<WindowId> &wids) const
+{
+    std::vector<QRect> geometries;
+    geometries.reserve(wids.size());
+
+    for (const auto &info : requestInfos(wids)) {
+        geometries.push_back(info.isValid() ? info.geometry() : QRect());
+    }
 
-    if (it != m_views.end())
-        m_views.erase(it);
+    return geometries;
+}
+
+void AbstractWindowInterface::updateWindowInfo(WindowId wid)
+{
+    updateWindowsInfo({wid});
+}
+
+void AbstractWindowInterface::updateWindowsInfo(const std::vector<WindowId> &wids)
+{
+    storeWindowsInfo(wids, requestInfos(wids));
+}
+
+void AbstractWindowInterface::updateWindowsGeometry(const std::vector<WindowId> &wids)
+{
+    const std::vector<QRect> geometries = requestGeometries(wids);
+
+    //! windows whose geometry could not be read are requested completely,
+    //! that way they are removed properly when they are not valid any more
+    std::vector<WindowId> infoWids;
+
+    for (size_t i = 0; i < geometries.size(); ++i) {
+        const int pos = m_windowsInfoIndex.indexOf(wids[i]);
+
+        if (pos < 0 || geometries[i].isNull() || geometries[i] == QRect(0, 0, 0, 0)) {
+            infoWids.push_back(wids[i]);
+            continue;
+        }
+
+        m_windowsInfo[pos].setGeometry(geometries[i]);
+        m_geometryIndex.insert(wids[i], geometries[i]);
+
+        //! a window whose changes were skipped entered the interest region
+        if (m_staleWindows.contains(wids[i]) && isInteresting(geometries[i])) {
+            infoWids.push_back(wids[i]);
+        }
+    }
+
+    if (!infoWids.empty()) {
+        updateWindowsInfo(infoWids);
+    }
+}
+
+void AbstractWindowInterface::storeWindowsInfo(const std::vector<WindowId> &wids, std::vector<WindowInfoWrap> infos)
+{
+    for (size_t i = 0; i < infos.size(); ++i) {
+        WindowInfoWrap &winfo = infos[i];
+
+        //! the notification window is not sending a remove signal and creates windows of geometry (0x0 0,0),
+        //! such windows are not stored in order to not break the cache validity
+        if (!winfo.isValid() || (!winfo.isPlasmaDesktop() && winfo.geometry() == QRect(0, 0, 0, 0))) {
+            removeWindowInfo(wids[i]);
+            continue;
+        }
+
+        winfo.setActivitiesMask(activitiesMask(winfo.activities()));
+
+        //! a scheme that was set before the window class was known becomes the class scheme
+        if (!winfo.windowClass().isEmpty() && m_windowScheme.contains(wids[i])) {
+            m_classScheme[winfo.windowClass()] = m_windowScheme.take(wids[i]);
+        }
+
+        m_staleWindows.remove(wids[i]);
+
+        m_geometryIndex.insert(wids[i], winfo.geometry());
+
+        if (winfo.isFullscreen() && !m_fullscreenWindows.contains(wids[i])) {
+            m_fullscreenWindows.append(wids[i]);
+        } else if (!winfo.isFullscreen()) {
+            m_fullscreenWindows.removeAll(wids[i]);
+        }
+
+        const int pos = m_windowsInfoIndex.insert(wids[i]);
+
+        if (pos < static_cast<int>(m_windowsInfo.size())) {
+            m_windowsInfo[pos] = std::move(winfo);
+        } else {
+            m_windowsInfo.push_back(std::move(winfo));
+        }
+    }
+}
+
+void AbstractWindowInterface::removeWindowInfo(WindowId wid)
+{
+    //! the registry moves the last window in the removed position,
+    //! the states storage follows the same move in order to stay packed
+    const int pos = m_windowsInfoIndex.remove(wid);
+
+    m_staleWindows.remove(wid);
+
+    if (pos < 0) {
+        return;
+    }
+
+    const int last = static_cast<int>(m_windowsInfo.size()) - 1;
+
+    if (pos != last) {
+        m_windowsInfo[pos] = std::move(m_windowsInfo[last]);
+    }
+
+    m_windowsInfo.pop_back();
+
+    m_geometryIndex.remove(wid);
+    m_fullscreenWindows.removeAll(wid);
 }
 
 
@@ -103,40 +520,84 @@ void AbstractWindowInterface::updateDefaultScheme()
     }
 }
 
+SchemeColors *AbstractWindowInterface::loadedScheme(const QString &scheme)
+{
+    //! scheme names are resolved to their files only once
+    QString schemeFile = m_schemeFiles.value(scheme);
+
+    if (schemeFile.isEmpty()) {
+        schemeFile = SchemeColors::possibleSchemeFile(scheme);
+
+        if (!schemeFile.isEmpty()) {
+            m_schemeFiles[scheme] = schemeFile;
+        }
+    }
+
+    if (!m_schemes.contains(schemeFile)) {
+        //! when this scheme file has not been loaded yet
+        m_schemes[schemeFile] = new SchemeColors(this, schemeFile);
+    }
+
+    return m_schemes[schemeFile];
+}
+
 SchemeColors *AbstractWindowInterface::schemeForWindow(WindowId wid)
 {
-    if (!m_windowScheme.contains(wid)) {
-        return m_schemes["kdeglobals"];
-    } else {
-        return m_schemes[m_windowScheme[wid]];
+    //! resolved only from memory, scheme files are loaded when they are set
+    auto windowScheme = m_windowScheme.constFind(wid);
+
+    if (windowScheme != m_windowScheme.constEnd()) {
+        return *windowScheme;
     }
 
-    return nullptr;
+    if (hasWindowInfo(wid) && !windowInfo(wid).windowClass().isEmpty()) {
+        auto classScheme = m_classScheme.constFind(windowInfo(wid).windowClass());
+
+        if (classScheme != m_classScheme.constEnd()) {
+            return *classScheme;
+        }
+    }
+
+    return m_schemes["kdeglobals"];
 }
 
 void AbstractWindowInterface::setColorSchemeForWindow(WindowId wid, QString scheme)
 {
-    if (scheme == "kdeglobals" && !m_windowScheme.contains(wid)) {
-        //default scheme does not have to be set
-        return;
+    setColorSchemeForWindows({{wid, scheme}});
+}
+
+void AbstractWindowInterface::setColorSchemeForWindows(const QHash<WindowId, QString> &schemes)
+{
+    const WindowId activeWid = activeWindow();
+    SchemeColors *activeScheme = schemeForWindow(activeWid);
+
+    for (auto it = schemes.constBegin(); it != schemes.constEnd(); ++it) {
+        applyColorScheme(it.key(), it.value());
     }
 
+    if (schemeForWindow(activeWid) != activeScheme) {
+        emit activeWindowChanged(activeWid);
+    }
+}
+
+void AbstractWindowInterface::applyColorScheme(WindowId wid, const QString &scheme)
+{
+    //! the scheme is shared by all the windows of the same application,
+    //! windows with no known class keep their own scheme
+    const QString windowClass = hasWindowInfo(wid) ? windowInfo(wid).windowClass() : QString();
+
     if (scheme == "kdeglobals") {
         //! a window that previously had an explicit set scheme now is set back to default scheme
         m_windowScheme.remove(wid);
-    } else {
-        QString schemeFile = SchemeColors::possibleSchemeFile(scheme);
 
-        if (!m_schemes.contains(schemeFile)) {
-            //! when this scheme file has not been loaded yet
-            m_schemes[schemeFile] = new SchemeColors(this, schemeFile);
-        }
-
-        m_windowScheme[wid] = schemeFile;
-
-        if (wid == activeWindow()) {
-            emit activeWindowChanged(wid);
+        if (!windowClass.isEmpty()) {
+            m_classScheme.remove(windowClass);
         }
+    } else if (!windowClass.isEmpty()) {
+        m_windowScheme.remove(wid);
+        m_classScheme[windowClass] = loadedScheme(scheme);
+    } else {
+        m_windowScheme[wid] = loadedScheme(scheme);
     }
 }
 
@@ -24,22 +24,29 @@
 // local
 #include "schemecolors.h"
 #include "windowinfowrap.h"
+#include "windowsgeometryindex.h"
+#include "windowsregistry.h"
 #include "../liblatte2/types.h"
 #include "../liblatte2/extras.h"
 
 // C++
 #include <unordered_map>
-#include <list>
+#include <vector>
 
 // Qt
+#include <QBitArray>
+#include <QHash>
 #include <QObject>
 #include <QWindow>
 #include <QDialog>
 #include <QMap>
 #include <QRect>
+#include <QRegion>
 #include <QPoint>
 #include <QPointer>
 #include <QScreen>
+#include <QSet>
+#include <QTimer>
 
 // KDE
 #include <KActivities/Consumer>
@@ -66,6 +73,19 @@ public:
         Right,
     };
 
+    //! window state fields that changed for a window
+    enum ChangedProperty
+    {
+        NoProperty = 0,
+        GeometryProperty = 1,
+        StateProperty = 1 << 1,
+        ActiveProperty = 1 << 2,
+        DesktopProperty = 1 << 3,
+        ActivitiesProperty = 1 << 4,
+        AllProperties = GeometryProperty | StateProperty | ActiveProperty | DesktopProperty | ActivitiesProperty
+    };
+    Q_DECLARE_FLAGS(ChangedProperties, ChangedProperty)
+
     explicit AbstractWindowInterface(QObject *parent = nullptr);
     virtual ~AbstractWindowInterface();
 
@@ -78,10 +98,16 @@ public:
 
     virtual WindowId activeWindow() const = 0;
     virtual WindowInfoWrap requestInfo(WindowId wid) const = 0;
+    //! batched version of requestInfo(), backends that can pipeline their
+    //! requests should override it
+    virtual std::vector<WindowInfoWrap> requestInfos(const std::vector<WindowId> &wids) const;
+    //! only the window geometries, used when nothing else changed for the windows,
+    //! a null rect means that the window state must be requested completely
+    virtual std::vector<QRect> requestGeometries(const std::vector<WindowId> &wids) const;
     virtual WindowInfoWrap requestInfoActive() const = 0;
     virtual bool isOnCurrentDesktop(WindowId wid) const = 0;
     virtual bool isOnCurrentActivity(WindowId wid) const = 0;
-    virtual const std::list<WindowId> &windows() const = 0;
+    virtual const std::vector<WindowId> &windows() const = 0;
 
     virtual void setKeepAbove(const QDialog &dialog, bool above = true) const = 0;
     virtual void skipTaskBar(const QDialog &dialog) const = 0;
@@ -97,31 +123,119 @@ public:
     void addView(WindowId wid);
     void removeView(WindowId wid);
 
+    //! shared window state cache, it is filled once per window event
+    //! and all views can query it by const reference
+    bool hasWindowInfo(WindowId wid) const;
+    const WindowInfoWrap &windowInfo(WindowId wid) const;
+    const std::vector<WindowInfoWrap> &windowsInfo() const;
+
+    //! desktop and activity membership answered from the window states cache,
+    //! activities are interned to small integer ids
+    bool inCurrentDesktop(const WindowInfoWrap &winfo) const;
+    bool inCurrentActivity(const WindowInfoWrap &winfo) const;
+
+    virtual int currentDesktop() const;
+    QString currentActivity() const;
+
+    //! window states are acquired only for the windows found in regions that
+    //! consumers are interested in, consumers are forgotten when they are destroyed
+    void setInterest(const QObject *consumer, const QRegion &region);
+    void removeInterest(const QObject *consumer);
+    bool hasInterest() const;
+
+    //! windows whose geometry intersects the given area
+    QVector<WindowId> windowsIn(const QRect &area) const;
+    const QList<WindowId> &fullscreenWindows() const;
+
+    //! window changes are merged per window and are delivered once per interval
+    int windowChangesInterval() const;
+    void setWindowChangesInterval(int msec);
+
     SchemeColors *schemeForWindow(WindowId wId);
     void setColorSchemeForWindow(WindowId wId, QString scheme);
+    //! all the schemes are applied before the views are informed once
+    void setColorSchemeForWindows(const QHash<WindowId, QString> &schemes);
 
 signals:
     void activeWindowChanged(WindowId wid);
-    void windowChanged(WindowId winfo);
+    //! the window states cache is already updated for these windows,
+    //! each one carries only its own changed properties
+    void windowsChanged(const QHash<WindowId, ChangedProperties> &changes);
     void windowAdded(WindowId wid);
     void windowRemoved(WindowId wid);
     void currentDesktopChanged();
     void currentActivityChanged();
 
 protected:
-    std::list<WindowId> m_windows;
-    std::list<WindowId> m_views;
+    void queueWindowChanged(WindowId wid, ChangedProperties properties);
+    void updateWindowsInfo(const std::vector<WindowId> &wids);
+    //! updates only the geometries of already stored windows
+    void updateWindowsGeometry(const std::vector<WindowId> &wids);
+    //! stores window states that the backend has already requested
+    void storeWindowsInfo(const std::vector<WindowId> &wids, std::vector<WindowInfoWrap> infos);
+
+    bool isInteresting(const QRect &geometry) const;
+    //! the first consumer registered its interest, the window states that
+    //! were not acquired until now must be requested
+    virtual void interestGained();
+
+    WindowsRegistry m_windows;
+    WindowsRegistry m_views;
     QPointer<KActivities::Consumer> m_activities;
 
+protected slots:
+    //! delivers the queued window changes immediately
+    void flushWindowChanges();
+
 private slots:
     void updateDefaultScheme();
 
+    void updateWindowInfo(WindowId wid);
+    void removeWindowInfo(WindowId wid);
+
+private:
+    int activityId(const QString &activity) const;
+    static bool sameStates(const WindowInfoWrap &winfo1, const WindowInfoWrap &winfo2);
+    void updateInterestRegion();
+    SchemeColors *loadedScheme(const QString &scheme);
+    void applyColorScheme(WindowId wid, const QString &scheme);
+    QBitArray activitiesMask(const QStringList &activities) const;
+
 private:
+    mutable int m_currentActivityId{-1};
+    mutable QHash<QString, int> m_activitiesIds;
+
+    //! windows that changed and their changed properties since the last flush
+    QHash<WindowId, ChangedProperties> m_pendingChanges;
+    QTimer m_windowChangesTimer;
+
+    WindowId m_lastActiveWindow{0};
+
+    //! packed window states, the registry mirrors their positions
+    std::vector<WindowInfoWrap> m_windowsInfo;
+    WindowsRegistry m_windowsInfoIndex;
+
+    WindowsGeometryIndex m_geometryIndex;
+
+    //! consumers and their regions of interest
+    QHash<const QObject *, QRegion> m_interests;
+    QRegion m_interestRegion;
+
+    //! stored windows out of the interest region, their state changes were skipped
+    QSet<WindowId> m_staleWindows;
+    QList<WindowId> m_fullscreenWindows;
+
     //! scheme file and its loaded colors
     QMap<QString, SchemeColors *> m_schemes;
 
-    //! window id and its corresponding scheme file
-    QMap<WindowId, QString> m_windowScheme;
+    //! scheme name and its resolved scheme file
+    QHash<QString, QString> m_schemeFiles;
+
+    //! window class and the scheme shared by all its windows
+    QHash<QString, SchemeColors *> m_classScheme;
+
+    //! windows with no known class and their scheme
+    QHash<WindowId, SchemeColors *> m_windowScheme;
 
 };
 
@@ -129,4 +243,7 @@ private:
 using WindowSystem = AbstractWindowInterface;
 
 }
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(Latte::AbstractWindowInterface::ChangedProperties)
+
 #endif // ABSTRACTWINDOWINTERFACE_H
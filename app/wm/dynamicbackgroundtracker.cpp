@@ -0,0 +1,207 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "dynamicbackgroundtracker.h"
+
+// local
+#include "../lattecorona.h"
+#include "../../liblatte2/types.h"
+
+namespace Latte {
+
+DynamicBackgroundTracker::DynamicBackgroundTracker(Latte::Corona *corona)
+    : QObject(corona),
+      m_corona(corona),
+      m_wm(corona->wm())
+{
+    connect(m_corona, &Plasma::Corona::availableScreenRectChanged, this, &DynamicBackgroundTracker::updateScreensGeometries);
+
+    connect(m_wm, &AbstractWindowInterface::windowsChanged, this, &DynamicBackgroundTracker::update);
+    connect(m_wm, &AbstractWindowInterface::windowRemoved, this, &DynamicBackgroundTracker::update);
+    connect(m_wm, &AbstractWindowInterface::windowAdded, this, &DynamicBackgroundTracker::update);
+    connect(m_wm, &AbstractWindowInterface::activeWindowChanged, this, &DynamicBackgroundTracker::update);
+    connect(m_wm, &AbstractWindowInterface::currentDesktopChanged, this, &DynamicBackgroundTracker::update);
+    connect(m_wm, &AbstractWindowInterface::currentActivityChanged, this, &DynamicBackgroundTracker::update);
+}
+
+DynamicBackgroundTracker::~DynamicBackgroundTracker()
+{
+}
+
+void DynamicBackgroundTracker::subscribe(int screenId, Plasma::Types::Location edge)
+{
+    const bool newScreen = !m_screens.contains(screenId);
+    ScreenSummary &summary = m_screens[screenId];
+    EdgeSummary &edgeSummary = summary.edges[edge];
+
+    edgeSummary.views++;
+
+    if (newScreen) {
+        summary.geometry = m_corona->screenGeometry(screenId);
+        summary.availableGeometry = m_corona->availableScreenRectWithCriteria(screenId, {Types::AlwaysVisible}, {});
+        updateInterest();
+    }
+
+    if (newScreen || edgeSummary.views == 1) {
+        updateScreen(summary, m_wm->windowInfo(m_wm->activeWindow()));
+    }
+}
+
+void DynamicBackgroundTracker::unsubscribe(int screenId, Plasma::Types::Location edge)
+{
+    auto screen = m_screens.find(screenId);
+
+    if (screen == m_screens.end()) {
+        return;
+    }
+
+    auto edgeSummary = screen->edges.find(edge);
+
+    if (edgeSummary == screen->edges.end()) {
+        return;
+    }
+
+    if (--edgeSummary->views <= 0) {
+        screen->edges.erase(edgeSummary);
+    }
+
+    if (screen->edges.isEmpty()) {
+        m_screens.erase(screen);
+        updateInterest();
+    }
+}
+
+bool DynamicBackgroundTracker::existsWindowMaximized(int screenId) const
+{
+    return maximizedWindow(screenId) != 0;
+}
+
+WindowId DynamicBackgroundTracker::maximizedWindow(int screenId) const
+{
+    auto screen = m_screens.constFind(screenId);
+
+    return screen != m_screens.constEnd() ? screen->maximizedWindow : 0;
+}
+
+bool DynamicBackgroundTracker::existsWindowTouching(int screenId, Plasma::Types::Location edge) const
+{
+    auto screen = m_screens.constFind(screenId);
+
+    if (screen == m_screens.constEnd()) {
+        return false;
+    }
+
+    return screen->edges.value(edge).touching;
+}
+
+void DynamicBackgroundTracker::update()
+{
+    if (m_screens.isEmpty()) {
+        return;
+    }
+
+    const WindowInfoWrap &activeInfo = m_wm->windowInfo(m_wm->activeWindow());
+
+    for (auto &summary : m_screens) {
+        updateScreen(summary, activeInfo);
+    }
+
+    emit updated();
+}
+
+void DynamicBackgroundTracker::updateScreensGeometries()
+{
+    for (auto it = m_screens.begin(); it != m_screens.end(); ++it) {
+        it->geometry = m_corona->screenGeometry(it.key());
+        it->availableGeometry = m_corona->availableScreenRectWithCriteria(it.key(), {Types::AlwaysVisible}, {});
+    }
+
+    updateInterest();
+    update();
+}
+
+void DynamicBackgroundTracker::updateInterest()
+{
+    //! only the windows of the subscribed screens are needed
+    QRegion region;
+
+    for (const auto &summary : m_screens) {
+        region += summary.geometry;
+    }
+
+    m_wm->setInterest(this, region);
+}
+
+void DynamicBackgroundTracker::updateScreen(ScreenSummary &summary, const WindowInfoWrap &activeInfo)
+{
+    //! a maximized window in a screen has its center inside the available screen geometry
+    //! in order to avoid: https://bugs.kde.org/show_bug.cgi?id=397700
+    summary.maximizedWindow = 0;
+
+    for (const auto &wid : m_wm->windowsIn(summary.availableGeometry)) {
+        const WindowInfoWrap &winfo = m_wm->windowInfo(wid);
+
+        if (isShown(winfo) && winfo.isMaximized() && summary.availableGeometry.contains(winfo.geometry().center())) {
+            summary.maximizedWindow = wid;
+        }
+    }
+
+    //! only the active window can be touching an edge
+    for (auto it = summary.edges.begin(); it != summary.edges.end(); ++it) {
+        it->touching = activeInfo.isActive()
+                       && isTouchingEdge(activeInfo, summary, static_cast<Plasma::Types::Location>(it.key()));
+    }
+}
+
+bool DynamicBackgroundTracker::isShown(const WindowInfoWrap &winfo) const
+{
+    return winfo.isValid() && !winfo.isMinimized() && m_wm->inCurrentDesktop(winfo) && m_wm->inCurrentActivity(winfo);
+}
+
+bool DynamicBackgroundTracker::isTouchingEdge(const WindowInfoWrap &winfo, const ScreenSummary &summary, Plasma::Types::Location edge) const
+{
+    if (!isShown(winfo)) {
+        return false;
+    }
+
+    const QRect &geometry = winfo.geometry();
+
+    if (!summary.geometry.contains(geometry.topLeft()) && !summary.geometry.contains(geometry.bottomRight())) {
+        return false;
+    }
+
+    switch (edge) {
+        case Plasma::Types::TopEdge:
+            return geometry.y() == summary.availableGeometry.y();
+
+        case Plasma::Types::BottomEdge:
+            return geometry.bottom() == summary.availableGeometry.bottom();
+
+        case Plasma::Types::LeftEdge:
+            return geometry.x() == summary.availableGeometry.x();
+
+        case Plasma::Types::RightEdge:
+            return geometry.right() == summary.availableGeometry.right();
+
+        default:
+            return false;
+    }
+}
+
+}
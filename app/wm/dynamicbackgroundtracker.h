@@ -0,0 +1,98 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef DYNAMICBACKGROUNDTRACKER_H
+#define DYNAMICBACKGROUNDTRACKER_H
+
+// local
+#include "abstractwindowinterface.h"
+#include "windowinfowrap.h"
+
+// Qt
+#include <QHash>
+#include <QObject>
+#include <QRect>
+
+// Plasma
+#include <Plasma>
+
+namespace Latte {
+class Corona;
+}
+
+namespace Latte {
+
+//! Shared windows summary for the views dynamic background. For every screen and
+//! edge that views are subscribed to, it is evaluated once per window state change:
+//! the maximized window present in the screen and whether the active window is
+//! touching the edge. Views read it instead of scanning the windows on their own.
+class DynamicBackgroundTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    DynamicBackgroundTracker(Latte::Corona *corona);
+    ~DynamicBackgroundTracker() override;
+
+    void subscribe(int screenId, Plasma::Types::Location edge);
+    void unsubscribe(int screenId, Plasma::Types::Location edge);
+
+    bool existsWindowMaximized(int screenId) const;
+    //! 0 when there is no maximized window in the screen
+    WindowId maximizedWindow(int screenId) const;
+    //! the active window is touching the edge
+    bool existsWindowTouching(int screenId, Plasma::Types::Location edge) const;
+
+signals:
+    //! the summary has been evaluated again
+    void updated();
+
+private slots:
+    void update();
+    void updateScreensGeometries();
+
+private:
+    struct EdgeSummary {
+        int views{0};
+        bool touching{false};
+    };
+
+    struct ScreenSummary {
+        QRect geometry;
+        QRect availableGeometry;
+        WindowId maximizedWindow{0};
+        QHash<int, EdgeSummary> edges;
+    };
+
+    void updateInterest();
+    void updateScreen(ScreenSummary &summary, const WindowInfoWrap &activeInfo);
+
+    bool isShown(const WindowInfoWrap &winfo) const;
+    bool isTouchingEdge(const WindowInfoWrap &winfo, const ScreenSummary &summary, Plasma::Types::Location edge) const;
+
+private:
+    QHash<int, ScreenSummary> m_screens;
+
+    Latte::Corona *m_corona{nullptr};
+    AbstractWindowInterface *m_wm{nullptr};
+};
+
+}
+
+#endif
@@ -0,0 +1,232 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "syntheticwindowinterface.h"
+
+// KDE
+#include <KWindowSystem>
+
+namespace Latte {
+
+SyntheticWindowInterface::SyntheticWindowInterface(AbstractWindowInterface *host, QObject *parent)
+    : AbstractWindowInterface(parent),
+      m_host(host),
+      m_currentDesktop(KWindowSystem::currentDesktop())
+{
+    m_activities = new KActivities::Consumer(this);
+
+    connect(m_activities.data(), &KActivities::Consumer::currentActivityChanged
+            , this, &SyntheticWindowInterface::currentActivityChanged);
+}
+
+SyntheticWindowInterface::~SyntheticWindowInterface()
+{
+}
+
+void SyntheticWindowInterface::setViewExtraFlags(QWindow &view)
+{
+    if (m_host) {
+        m_host->setViewExtraFlags(view);
+    }
+}
+
+void SyntheticWindowInterface::setViewStruts(QWindow &view, const QRect &rect, Plasma::Types::Location location)
+{
+    if (m_host) {
+        m_host->setViewStruts(view, rect, location);
+    }
+}
+
+void SyntheticWindowInterface::setWindowOnActivities(QWindow &window, const QStringList &activities)
+{
+    if (m_host) {
+        m_host->setWindowOnActivities(window, activities);
+    }
+}
+
+void SyntheticWindowInterface::removeViewStruts(QWindow &view) const
+{
+    if (m_host) {
+        m_host->removeViewStruts(view);
+    }
+}
+
+WindowId SyntheticWindowInterface::activeWindow() const
+{
+    return m_activeWindow;
+}
+
+WindowInfoWrap SyntheticWindowInterface::requestInfo(WindowId wid) const
+{
+    return m_states.value(wid);
+}
+
+WindowInfoWrap SyntheticWindowInterface::requestInfoActive() const
+{
+    return requestInfo(m_activeWindow);
+}
+
+int SyntheticWindowInterface::currentDesktop() const
+{
+    return m_currentDesktop;
+}
+
+bool SyntheticWindowInterface::isOnCurrentDesktop(WindowId wid) const
+{
+    return hasWindowInfo(wid) && inCurrentDesktop(windowInfo(wid));
+}
+
+bool SyntheticWindowInterface::isOnCurrentActivity(WindowId wid) const
+{
+    return hasWindowInfo(wid) && inCurrentActivity(windowInfo(wid));
+}
+
+const std::vector<WindowId> &SyntheticWindowInterface::windows() const
+{
+    return m_windows.windows();
+}
+
+void SyntheticWindowInterface::setKeepAbove(const QDialog &dialog, bool above) const
+{
+    if (m_host) {
+        m_host->setKeepAbove(dialog, above);
+    }
+}
+
+void SyntheticWindowInterface::skipTaskBar(const QDialog &dialog) const
+{
+    if (m_host) {
+        m_host->skipTaskBar(dialog);
+    }
+}
+
+void SyntheticWindowInterface::slideWindow(QWindow &view, Slide location) const
+{
+    if (m_host) {
+        m_host->slideWindow(view, location);
+    }
+}
+
+void SyntheticWindowInterface::enableBlurBehind(QWindow &view) const
+{
+    if (m_host) {
+        m_host->enableBlurBehind(view);
+    }
+}
+
+void SyntheticWindowInterface::setEdgeStateFor(QWindow *view, bool active) const
+{
+    if (m_host) {
+        m_host->setEdgeStateFor(view, active);
+    }
+}
+
+void SyntheticWindowInterface::releaseMouseEventFor(WindowId wid) const
+{
+    Q_UNUSED(wid);
+}
+
+void SyntheticWindowInterface::requestToggleMaximized(WindowId wid) const
+{
+    //! synthetic windows change only through their events
+    Q_UNUSED(wid);
+}
+
+void SyntheticWindowInterface::requestMoveWindow(WindowId wid, QPoint from) const
+{
+    Q_UNUSED(wid);
+    Q_UNUSED(from);
+}
+
+bool SyntheticWindowInterface::windowCanBeDragged(WindowId wid) const
+{
+    const WindowInfoWrap &winfo = windowInfo(wid);
+    return (winfo.isValid() && !winfo.isPlasmaDesktop() && !winfo.hasSkipTaskbar());
+}
+
+void SyntheticWindowInterface::addWindow(const WindowInfoWrap &winfo)
+{
+    if (m_windows.contains(winfo.wid())) {
+        return;
+    }
+
+    m_states[winfo.wid()] = winfo;
+    m_windows.insert(winfo.wid());
+
+    emit windowAdded(winfo.wid());
+}
+
+void SyntheticWindowInterface::removeWindow(WindowId wid)
+{
+    if (m_windows.remove(wid) < 0) {
+        return;
+    }
+
+    m_states.remove(wid);
+
+    if (m_activeWindow == wid) {
+        m_activeWindow = 0;
+    }
+
+    emit windowRemoved(wid);
+}
+
+void SyntheticWindowInterface::changeWindow(const WindowInfoWrap &winfo, ChangedProperties properties)
+{
+    if (!m_windows.contains(winfo.wid())) {
+        return;
+    }
+
+    m_states[winfo.wid()] = winfo;
+
+    queueWindowChanged(winfo.wid(), properties);
+    flushWindowChanges();
+}
+
+void SyntheticWindowInterface::setActiveWindow(WindowId wid)
+{
+    if (m_activeWindow == wid) {
+        return;
+    }
+
+    if (m_states.contains(m_activeWindow)) {
+        m_states[m_activeWindow].setIsActive(false);
+    }
+
+    if (m_states.contains(wid)) {
+        m_states[wid].setIsActive(true);
+    }
+
+    m_activeWindow = wid;
+
+    emit activeWindowChanged(wid);
+}
+
+void SyntheticWindowInterface::setCurrentDesktop(int desktop)
+{
+    if (m_currentDesktop == desktop) {
+        return;
+    }
+
+    m_currentDesktop = desktop;
+
+    emit currentDesktopChanged();
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SYNTHETICWINDOWINTERFACE_H
+#define SYNTHETICWINDOWINTERFACE_H
+
+// local
+#include "abstractwindowinterface.h"
+#include "windowinfowrap.h"
+
+// Qt
+#include <QHash>
+#include <QObject>
+
+namespace Latte {
+
+//! Offline window tracking, the windows, their events and the current desktop are
+//! provided by the caller instead of the window manager. Everything that concerns
+//! the views themselves (flags, struts, effects etc.) is forwarded to the real
+//! window system backend, when there is one.
+//! It is used by the developers tools in order to drive the visibility code
+//! without a live window manager session.
+class SyntheticWindowInterface : public AbstractWindowInterface
+{
+    Q_OBJECT
+
+public:
+    //! the host can be null when there are no views to show
+    explicit SyntheticWindowInterface(AbstractWindowInterface *host, QObject *parent = nullptr);
+    ~SyntheticWindowInterface() override;
+
+    void setViewExtraFlags(QWindow &view) override;
+    void setViewStruts(QWindow &view, const QRect &rect
+                       , Plasma::Types::Location location) override;
+    void setWindowOnActivities(QWindow &window, const QStringList &activities) override;
+
+    void removeViewStruts(QWindow &view) const override;
+
+    WindowId activeWindow() const override;
+    WindowInfoWrap requestInfo(WindowId wid) const override;
+    WindowInfoWrap requestInfoActive() const override;
+    bool isOnCurrentDesktop(WindowId wid) const override;
+    bool isOnCurrentActivity(WindowId wid) const override;
+    const std::vector<WindowId> &windows() const override;
+
+    int currentDesktop() const override;
+
+    void setKeepAbove(const QDialog &dialog, bool above = true) const override;
+    void skipTaskBar(const QDialog &dialog) const override;
+    void slideWindow(QWindow &view, Slide location) const override;
+    void enableBlurBehind(QWindow &view) const override;
+    void setEdgeStateFor(QWindow *view, bool active) const override;
+
+    void releaseMouseEventFor(WindowId wid) const override;
+    void requestToggleMaximized(WindowId wid) const override;
+    void requestMoveWindow(WindowId wid, QPoint from) const override;
+    bool windowCanBeDragged(WindowId wid) const override;
+
+    //! window events, changes are delivered synchronously instead of once per interval
+    void addWindow(const WindowInfoWrap &winfo);
+    void removeWindow(WindowId wid);
+    void changeWindow(const WindowInfoWrap &winfo, ChangedProperties properties);
+    void setActiveWindow(WindowId wid);
+    void setCurrentDesktop(int desktop);
+
+private:
+    AbstractWindowInterface *m_host{nullptr};
+
+    int m_currentDesktop{0};
+    WindowId m_activeWindow{0};
+    QHash<WindowId, WindowInfoWrap> m_states;
+};
+
+}
+
+#endif
@@ -30,7 +30,6 @@
 #include <QDebug>
 #include <QTimer>
 #include <QApplication>
-#include <QSignalMapper>
 #include <QtX11Extras/QX11Info>
 #include <QRasterWindow>
 
@@ -125,6 +124,10 @@ void WaylandInterface::initWindowManagement(KWayland::Client::PlasmaWindowManage
         auto w = m_windowManagement->activeWindow();
         emit activeWindowChanged(w ? w->internalId() : 0);
     }, Qt::QueuedConnection);
+
+    for (auto w : m_windowManagement->windows()) {
+        windowCreatedProxy(w);
+    }
 }
 
 KWayland::Client::PlasmaShell *WaylandInterface::waylandCoronaInterface() const
@@ -183,9 +186,9 @@ WindowId WaylandInterface::activeWindow() const
     return wid ? wid->internalId() : 0;
 }
 
-const std::list<WindowId> &WaylandInterface::windows() const
+const std::vector<WindowId> &WaylandInterface::windows() const
 {
-    return m_windows;
+    return m_windows.windows();
 }
 
 void WaylandInterface::setKeepAbove(const QDialog &dialog, bool above) const
@@ -260,108 +263,33 @@ void WaylandInterface::setEdgeStateFor(QWindow *view, bool active) const
 
 WindowInfoWrap WaylandInterface::requestInfoActive() const
 {
-    if (!m_windowManagement) {
-        return {};
-    }
-
-    auto w = m_windowManagement->activeWindow();
-
-    if (!w) return {};
-
-    WindowInfoWrap winfoWrap;
-
-    winfoWrap.setIsValid(true);
-
-    winfoWrap.setWid(w->internalId());
-
-    winfoWrap.setIsActive(w->isActive());
-
-    winfoWrap.setIsMinimized(w->isMinimized());
-
-    winfoWrap.setIsMaxVert(w->isMaximized());
-
-    winfoWrap.setIsMaxHoriz(w->isMaximized());
-
-    winfoWrap.setIsFullscreen(w->isFullscreen());
-
-    winfoWrap.setIsShaded(w->isShaded());
-
-    winfoWrap.setGeometry(w->geometry());
-
-    winfoWrap.setIsKeepAbove(w->isKeepAbove());
-
-    winfoWrap.setHasSkipTaskbar(w->skipTaskbar());
-
-    return winfoWrap;
+    return requestInfo(activeWindow());
 }
 
 bool WaylandInterface::isOnCurrentDesktop(WindowId wid) const
 {
-    if (!m_windowManagement) {
-        return false;
-    }
-
-    auto it = std::find_if(m_windowManagement->windows().constBegin(), m_windowManagement->windows().constEnd(), [&wid](PlasmaWindow * w) noexcept {
-        return w->isValid() && w->internalId() == wid;
-    });
+    const WindowInfoWrap &winfo = m_states.state(wid);
 
-    //qDebug() << "desktop:" << (it != m_windowManagement->windows().constEnd() ? (*it)->virtualDesktop() : -1) << KWindowSystem::currentDesktop();
-    //return true;
-    return it != m_windowManagement->windows().constEnd() && ((*it)->virtualDesktop() == KWindowSystem::currentDesktop() || (*it)->isOnAllDesktops());
+    return winfo.isValid() && inCurrentDesktop(winfo);
 }
 
 bool WaylandInterface::isOnCurrentActivity(WindowId wid) const
 {
-    auto it = std::find_if(m_windowManagement->windows().constBegin(), m_windowManagement->windows().constEnd(), [&wid](PlasmaWindow * w) noexcept {
-        return w->isValid() && w->internalId() == wid;
-    });
-
-    //TODO: Not yet implemented
-    return it != m_windowManagement->windows().constEnd() && true;
+    const WindowInfoWrap &winfo = m_states.state(wid);
 
+    //! activities are not exposed yet through wayland, windows have
+    //! no activities and are considered to be on all of them
+    return winfo.isValid() && winfo.isOnActivity(currentActivity());
 }
 
 WindowInfoWrap WaylandInterface::requestInfo(WindowId wid) const
 {
-    WindowInfoWrap winfoWrap;
-
-    auto w = windowFor(wid);
-
-    if (w) {
-        if (isValidWindow(w)) {
-            winfoWrap.setIsValid(true);
-            winfoWrap.setWid(wid);
-            winfoWrap.setIsActive(w->isActive());
-            winfoWrap.setIsMinimized(w->isMinimized());
-            winfoWrap.setIsMaxVert(w->isMaximized());
-            winfoWrap.setIsMaxHoriz(w->isMaximized());
-            winfoWrap.setIsFullscreen(w->isFullscreen());
-            winfoWrap.setIsShaded(w->isShaded());
-            winfoWrap.setGeometry(w->geometry());
-            winfoWrap.setHasSkipTaskbar(w->skipTaskbar());
-        } else if (w->appId() == QLatin1String("org.kde.plasmashell")) {
-            winfoWrap.setIsValid(true);
-            winfoWrap.setIsPlasmaDesktop(true);
-            winfoWrap.setWid(wid);
-        }
-    } else {
-        return {};
-    }
-
-    return winfoWrap;
+    return m_states.state(wid);
 }
 
 KWayland::Client::PlasmaWindow *WaylandInterface::windowFor(WindowId wid) const
 {
-    auto it = std::find_if(m_windowManagement->windows().constBegin(), m_windowManagement->windows().constEnd(), [&wid](PlasmaWindow * w) noexcept {
-        return w->isValid() && w->internalId() == wid;
-    });
-
-    if (it == m_windowManagement->windows().constEnd()) {
-        return nullptr;
-    }
-
-    return *it;
+    return m_plasmaWindows.value(wid, nullptr);
 }
 
 bool WaylandInterface::windowCanBeDragged(WindowId wid) const
@@ -380,7 +308,7 @@ void WaylandInterface::requestMoveWindow(WindowId wid, QPoint from) const
     if (windowCanBeDragged(wid)) {
         auto w = windowFor(wid);
 
-        if (w && isValidWindow(w)) {
+        if (w && WindowStates::isValidWindow(w)) {
             w->requestMove();
         }
     }
@@ -390,54 +318,93 @@ void WaylandInterface::requestToggleMaximized(WindowId wid) const
 {
     auto w = windowFor(wid);
 
-    if (w && isValidWindow(w)) {
+    if (w && WindowStates::isValidWindow(w)) {
         w->requestToggleMaximized();
     }
 }
 
-inline bool WaylandInterface::isValidWindow(const KWayland::Client::PlasmaWindow *w) const
+void WaylandInterface::windowPropertyChanged(KWayland::Client::PlasmaWindow *w, ChangedProperties properties)
+{
+    const WindowId wid = w->internalId();
+
+    //! e.g. skip taskbar state changes, windows start or stop being tracked
+    switch (m_states.update(w, properties)) {
+        case WindowStates::Added:
+            m_windows.insert(wid);
+            emit windowAdded(wid);
+            break;
+
+        case WindowStates::Removed:
+            m_windows.remove(wid);
+            emit windowRemoved(wid);
+            break;
+
+        case WindowStates::Changed:
+            queueWindowChanged(wid, properties);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void WaylandInterface::windowUnmappedProxy(WindowId wid)
 {
-    //! because wayland does not have any way yet to identify the window type
-    //! a trick is to just consider windows as valid when they can be shown in the
-    //! taskbar. Of course that creates issues with plasma native dialogs
-    //! e.g. widgets explorer, Activities etc. that are not used to hide
-    //! the dodge views appropriately
-    return w->isValid() && !w->skipTaskbar();
+    auto w = m_plasmaWindows.take(wid);
+
+    if (w) {
+        disconnect(w, nullptr, this, nullptr);
+    }
+
+    m_states.remove(wid);
+
+    if (m_windows.remove(wid) >= 0) {
+        emit windowRemoved(wid);
+    }
 }
 
 void WaylandInterface::windowCreatedProxy(KWayland::Client::PlasmaWindow *w)
 {
-    if (!isValidWindow(w)) return;
+    const WindowId wid = w->internalId();
 
-    if (!mapper) mapper = new QSignalMapper(this);
+    if (m_plasmaWindows.contains(wid)) {
+        return;
+    }
 
-    mapper->setMapping(w, w);
+    m_plasmaWindows[wid] = w;
 
-    connect(w, &PlasmaWindow::unmapped, this, [ &, win = w]() noexcept {
-        mapper->removeMappings(win);
-        m_windows.remove(win->internalId());
-        emit windowRemoved(win->internalId());
+    //! each window is connected only to its own handlers
+    connect(w, &PlasmaWindow::unmapped, this, [&, wid]() noexcept {
+        windowUnmappedProxy(wid);
+    });
+    connect(w, &QObject::destroyed, this, [&, wid]() noexcept {
+        windowUnmappedProxy(wid);
     });
 
-    connect(w, SIGNAL(activeChanged()), mapper, SLOT(map()));
-    connect(w, SIGNAL(fullscreenChanged()), mapper, SLOT(map()));
-    connect(w, SIGNAL(geometryChanged()), mapper, SLOT(map()));
-    connect(w, SIGNAL(maximizedChanged()), mapper, SLOT(map()));
-    connect(w, SIGNAL(minimizedChanged()), mapper, SLOT(map()));
-    connect(w, SIGNAL(shadedChanged()), mapper, SLOT(map()));
-    connect(w, SIGNAL(skipTaskbarChanged()), mapper, SLOT(map()));
-    connect(w, SIGNAL(onAllDesktopsChanged()), mapper, SLOT(map()));
-    connect(w, SIGNAL(virtualDesktopChanged()), mapper, SLOT(map()));
-
-    connect(mapper, static_cast<void (QSignalMapper::*)(QObject *)>(&QSignalMapper::mapped)
-    , this, [&](QObject * w) noexcept {
-        //qDebug() << "window changed:" << qobject_cast<PlasmaWindow *>(w)->appId();
-        emit windowChanged(qobject_cast<PlasmaWindow *>(w)->internalId());
+    connect(w, &PlasmaWindow::geometryChanged, this, [&, w]() noexcept {
+        windowPropertyChanged(w, GeometryProperty);
+    });
+    connect(w, &PlasmaWindow::activeChanged, this, [&, w]() noexcept {
+        windowPropertyChanged(w, ActiveProperty);
     });
 
-    m_windows.push_back(w->internalId());
+    for (auto signal : {&PlasmaWindow::fullscreenChanged, &PlasmaWindow::maximizedChanged
+                        , &PlasmaWindow::minimizedChanged, &PlasmaWindow::shadedChanged
+                        , &PlasmaWindow::keepAboveChanged, &PlasmaWindow::skipTaskbarChanged
+                        , &PlasmaWindow::appIdChanged}) {
+        connect(w, signal, this, [&, w]() noexcept {
+            windowPropertyChanged(w, StateProperty);
+        });
+    }
+
+    connect(w, &PlasmaWindow::onAllDesktopsChanged, this, [&, w]() noexcept {
+        windowPropertyChanged(w, DesktopProperty);
+    });
+    connect(w, &PlasmaWindow::virtualDesktopChanged, this, [&, w]() noexcept {
+        windowPropertyChanged(w, DesktopProperty);
+    });
 
-    emit windowAdded(w->internalId());
+    windowPropertyChanged(w, AllProperties);
 }
 
 }
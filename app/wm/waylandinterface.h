@@ -23,12 +23,13 @@
 
 // local
 #include "abstractwindowinterface.h"
+#include "waylandwindowstates.h"
 #include "windowinfowrap.h"
 
 // Qt
+#include <QHash>
 #include <QMap>
 #include <QObject>
-#include <QSignalMapper>
 
 // KDE
 #include <KWayland/Client/registry.h>
@@ -70,7 +71,7 @@ public:
     WindowInfoWrap requestInfoActive() const override;
     bool isOnCurrentDesktop(WindowId wid) const override;
     bool isOnCurrentActivity(WindowId wid) const override;
-    const std::list<WindowId> &windows() const override;
+    const std::vector<WindowId> &windows() const override;
 
     void setKeepAbove(const QDialog &dialog, bool above = true) const override;
     void skipTaskBar(const QDialog &dialog) const override;
@@ -87,13 +88,19 @@ public:
     void initWindowManagement(KWayland::Client::PlasmaWindowManagement *windowManagement);
 
 private:
+    using WindowStates = WaylandWindowStates<KWayland::Client::PlasmaWindow>;
+
     void init();
-    inline bool isValidWindow(const KWayland::Client::PlasmaWindow *w) const;
     void windowCreatedProxy(KWayland::Client::PlasmaWindow *w);
+    void windowUnmappedProxy(WindowId wid);
+    void windowPropertyChanged(KWayland::Client::PlasmaWindow *w, ChangedProperties properties);
     KWayland::Client::PlasmaWindow *windowFor(WindowId wid) const;
     KWayland::Client::PlasmaShell *waylandCoronaInterface() const;
 
-    QSignalMapper *mapper{nullptr};
+    //! all the plasma windows, including the ones that are not tracked as windows
+    QHash<WindowId, KWayland::Client::PlasmaWindow *> m_plasmaWindows;
+
+    WindowStates m_states;
 
     friend class Private::GhostWindow;
     mutable QMap<WindowId, Private::GhostWindow *> m_ghostWindows;
@@ -0,0 +1,148 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WAYLANDWINDOWSTATES_H
+#define WAYLANDWINDOWSTATES_H
+
+// local
+#include "abstractwindowinterface.h"
+#include "windowinfowrap.h"
+
+// Qt
+#include <QHash>
+#include <QLatin1String>
+
+namespace Latte {
+
+//! Window states store of the wayland backend. Each state is updated from the
+//! property signals of its own plasma window and only for the properties that
+//! changed, so the window states requests never touch the protocol objects.
+//! The plasma window type is a parameter in order to be tested without a
+//! wayland connection.
+template<class PlasmaWindow>
+class WaylandWindowStates
+{
+public:
+    //! what the window interface must do for the window after an update
+    enum Transition
+    {
+        NotTracked = 0,
+        Added,
+        Changed,
+        Removed
+    };
+
+    //! because wayland does not have any way yet to identify the window type
+    //! a trick is to just consider windows as valid when they can be shown in the
+    //! taskbar. Of course that creates issues with plasma native dialogs
+    //! e.g. widgets explorer, Activities etc. that are not used to hide
+    //! the dodge views appropriately
+    static bool isValidWindow(const PlasmaWindow *w)
+    {
+        return w->isValid() && !w->skipTaskbar();
+    }
+
+    bool contains(WindowId wid) const
+    {
+        return m_states.contains(wid);
+    }
+
+    //! an invalid state for windows that are not known
+    const WindowInfoWrap &state(WindowId wid) const
+    {
+        static const WindowInfoWrap invalid;
+
+        auto it = m_states.constFind(wid);
+
+        return it != m_states.constEnd() ? *it : invalid;
+    }
+
+    void remove(WindowId wid)
+    {
+        m_states.remove(wid);
+    }
+
+    Transition update(const PlasmaWindow *w, AbstractWindowInterface::ChangedProperties properties)
+    {
+        const WindowId wid = w->internalId();
+        WindowInfoWrap &winfo = m_states[wid];
+
+        const bool wasTracked = isTracked(winfo);
+
+        if (!isValidWindow(w)) {
+            winfo = WindowInfoWrap();
+
+            //! plasma desktop is needed when it becomes the active window
+            if (w->appId() == QLatin1String("org.kde.plasmashell")) {
+                winfo.setIsValid(true);
+                winfo.setIsPlasmaDesktop(true);
+                winfo.setWid(wid);
+            }
+
+            return wasTracked ? Removed : NotTracked;
+        }
+
+        //! a window that just became valid is filled completely
+        if (!wasTracked) {
+            winfo = WindowInfoWrap();
+            winfo.setIsValid(true);
+            winfo.setWid(wid);
+            properties = AbstractWindowInterface::AllProperties;
+        }
+
+        if (properties & AbstractWindowInterface::GeometryProperty) {
+            winfo.setGeometry(w->geometry());
+        }
+
+        if (properties & AbstractWindowInterface::StateProperty) {
+            winfo.setIsMinimized(w->isMinimized());
+            winfo.setIsMaxVert(w->isMaximized());
+            winfo.setIsMaxHoriz(w->isMaximized());
+            winfo.setIsFullscreen(w->isFullscreen());
+            winfo.setIsShaded(w->isShaded());
+            winfo.setIsKeepAbove(w->isKeepAbove());
+            winfo.setHasSkipTaskbar(w->skipTaskbar());
+            winfo.setWindowClass(w->appId());
+        }
+
+        if (properties & AbstractWindowInterface::ActiveProperty) {
+            winfo.setIsActive(w->isActive());
+        }
+
+        if (properties & AbstractWindowInterface::DesktopProperty) {
+            winfo.setIsOnAllDesktops(w->isOnAllDesktops());
+            winfo.setDesktop(w->virtualDesktop());
+        }
+
+        return wasTracked ? Changed : Added;
+    }
+
+private:
+    static bool isTracked(const WindowInfoWrap &winfo)
+    {
+        return winfo.isValid() && !winfo.isPlasmaDesktop();
+    }
+
+private:
+    QHash<WindowId, WindowInfoWrap> m_states;
+};
+
+}
+
+#endif
@@ -22,13 +22,15 @@
 #define WINDOWINFOWRAP_H
 
 // Qt
+#include <QBitArray>
 #include <QWindow>
 #include <QRect>
-#include <QVariant>
+#include <QStringList>
 
 namespace Latte {
 
-using WindowId = QVariant;
+//! X11 window ids and Wayland internal ids both fit in 32 bits
+using WindowId = quint32;
 
 class WindowInfoWrap
 {
@@ -44,12 +46,17 @@ public:
         , m_isShaded(false)
         , m_isPlasmaDesktop(false)
         , m_isKeepAbove(false)
-        , m_hasSkipTaskbar(false) {
+        , m_hasSkipTaskbar(false)
+        , m_isOnAllDesktops(false) {
     }
 
     WindowInfoWrap(const WindowInfoWrap &o) noexcept
         : m_wid(o.m_wid)
         , m_geometry(o.m_geometry)
+        , m_desktop(o.m_desktop)
+        , m_activities(o.m_activities)
+        , m_activitiesMask(o.m_activitiesMask)
+        , m_windowClass(o.m_windowClass)
         , m_isValid(o.m_isValid)
         , m_isActive(o.m_isActive)
         , m_isMinimized(o.m_isMinimized)
@@ -59,12 +66,17 @@ public:
         , m_isShaded(o.m_isShaded)
         , m_isPlasmaDesktop(o.m_isPlasmaDesktop)
         , m_isKeepAbove(o.m_isKeepAbove)
-        , m_hasSkipTaskbar(o.m_hasSkipTaskbar) {
+        , m_hasSkipTaskbar(o.m_hasSkipTaskbar)
+        , m_isOnAllDesktops(o.m_isOnAllDesktops) {
     }
 
     WindowInfoWrap(WindowInfoWrap &&o) noexcept
         : m_wid(std::move(o.m_wid))
         , m_geometry(std::move(o.m_geometry))
+        , m_desktop(o.m_desktop)
+        , m_activities(std::move(o.m_activities))
+        , m_activitiesMask(std::move(o.m_activitiesMask))
+        , m_windowClass(std::move(o.m_windowClass))
         , m_isValid(o.m_isValid)
         , m_isActive(o.m_isActive)
         , m_isMinimized(o.m_isMinimized)
@@ -74,7 +86,8 @@ public:
         , m_isShaded(o.m_isShaded)
         , m_isPlasmaDesktop(o.m_isPlasmaDesktop)
         , m_isKeepAbove(o.m_isKeepAbove)
-        , m_hasSkipTaskbar(o.m_hasSkipTaskbar) {
+        , m_hasSkipTaskbar(o.m_hasSkipTaskbar)
+        , m_isOnAllDesktops(o.m_isOnAllDesktops) {
     }
 
     inline WindowInfoWrap &operator=(WindowInfoWrap &&rhs) noexcept;
@@ -115,9 +128,31 @@ public:
     inline bool hasSkipTaskbar() const noexcept;
     inline void setHasSkipTaskbar(bool skipTaskbar) noexcept;
 
+    inline bool isOnAllDesktops() const noexcept;
+    inline void setIsOnAllDesktops(bool allDesktops) noexcept;
+
+    inline int desktop() const noexcept;
+    inline void setDesktop(int desktop) noexcept;
+
+    //! empty activities means that the window is shown in all activities
+    inline QStringList activities() const noexcept;
+    inline void setActivities(const QStringList &activities) noexcept;
+
+    //! interned activities, each set bit is the id of an activity the window is shown in
+    inline QBitArray activitiesMask() const noexcept;
+    inline void setActivitiesMask(const QBitArray &mask) noexcept;
+
+    inline bool isOnDesktop(int desktop) const noexcept;
+    inline bool isOnActivity(const QString &activity) const noexcept;
+    inline bool isOnActivity(int activityId) const noexcept;
+
     inline QRect geometry() const noexcept;
     inline void setGeometry(const QRect &geometry) noexcept;
 
+    //! X11 window class or Wayland app id, windows of the same application share it
+    inline QString windowClass() const noexcept;
+    inline void setWindowClass(const QString &windowClass) noexcept;
+
     inline WindowId wid() const noexcept;
     inline void setWid(WindowId wid) noexcept;
 
@@ -125,6 +160,12 @@ private:
     WindowId m_wid{0};
     QRect m_geometry;
 
+    int m_desktop{0};
+    QStringList m_activities;
+    QBitArray m_activitiesMask;
+
+    QString m_windowClass;
+
     bool m_isValid : 1;
     bool m_isActive : 1;
     bool m_isMinimized : 1;
@@ -135,6 +176,7 @@ private:
     bool m_isPlasmaDesktop : 1;
     bool m_isKeepAbove: 1;
     bool m_hasSkipTaskbar: 1;
+    bool m_isOnAllDesktops: 1;
 };
 
 // BEGIN: definitions
@@ -142,6 +184,10 @@ inline WindowInfoWrap &WindowInfoWrap::operator=(WindowInfoWrap &&rhs) noexcept
 {
     m_wid = std::move(rhs.m_wid);
     m_geometry = std::move(rhs.m_geometry);
+    m_desktop = rhs.m_desktop;
+    m_activities = std::move(rhs.m_activities);
+    m_activitiesMask = std::move(rhs.m_activitiesMask);
+    m_windowClass = std::move(rhs.m_windowClass);
     m_isValid = rhs.m_isValid;
     m_isActive = rhs.m_isActive;
     m_isMinimized = rhs.m_isMinimized;
@@ -152,6 +198,7 @@ inline WindowInfoWrap &WindowInfoWrap::operator=(WindowInfoWrap &&rhs) noexcept
     m_isPlasmaDesktop = rhs.m_isPlasmaDesktop;
     m_isKeepAbove = rhs.m_isKeepAbove;
     m_hasSkipTaskbar = rhs.m_hasSkipTaskbar;
+    m_isOnAllDesktops = rhs.m_isOnAllDesktops;
     return *this;
 }
 
@@ -159,6 +206,10 @@ inline WindowInfoWrap &WindowInfoWrap::operator=(const WindowInfoWrap &rhs) noex
 {
     m_wid = rhs.m_wid;
     m_geometry = std::move(rhs.m_geometry);
+    m_desktop = rhs.m_desktop;
+    m_activities = rhs.m_activities;
+    m_activitiesMask = rhs.m_activitiesMask;
+    m_windowClass = rhs.m_windowClass;
     m_isValid = rhs.m_isValid;
     m_isActive = rhs.m_isActive;
     m_isMinimized = rhs.m_isMinimized;
@@ -169,6 +220,7 @@ inline WindowInfoWrap &WindowInfoWrap::operator=(const WindowInfoWrap &rhs) noex
     m_isPlasmaDesktop = rhs.m_isPlasmaDesktop;
     m_isKeepAbove = rhs.m_isKeepAbove;
     m_hasSkipTaskbar = rhs.m_hasSkipTaskbar;
+    m_isOnAllDesktops = rhs.m_isOnAllDesktops;
     return *this;
 }
 
@@ -292,6 +344,62 @@ inline void WindowInfoWrap::setHasSkipTaskbar(bool skipTaskbar) noexcept
     m_hasSkipTaskbar = skipTaskbar;
 }
 
+inline bool WindowInfoWrap::isOnAllDesktops() const noexcept
+{
+    return m_isOnAllDesktops;
+}
+
+inline void WindowInfoWrap::setIsOnAllDesktops(bool allDesktops) noexcept
+{
+    m_isOnAllDesktops = allDesktops;
+}
+
+inline int WindowInfoWrap::desktop() const noexcept
+{
+    return m_desktop;
+}
+
+inline void WindowInfoWrap::setDesktop(int desktop) noexcept
+{
+    m_desktop = desktop;
+}
+
+inline QStringList WindowInfoWrap::activities() const noexcept
+{
+    return m_activities;
+}
+
+inline void WindowInfoWrap::setActivities(const QStringList &activities) noexcept
+{
+    m_activities = activities;
+}
+
+inline QBitArray WindowInfoWrap::activitiesMask() const noexcept
+{
+    return m_activitiesMask;
+}
+
+inline void WindowInfoWrap::setActivitiesMask(const QBitArray &mask) noexcept
+{
+    m_activitiesMask = mask;
+}
+
+inline bool WindowInfoWrap::isOnDesktop(int desktop) const noexcept
+{
+    return m_isOnAllDesktops || m_desktop == desktop;
+}
+
+inline bool WindowInfoWrap::isOnActivity(const QString &activity) const noexcept
+{
+    return m_activities.isEmpty() || m_activities.contains(activity);
+}
+
+inline bool WindowInfoWrap::isOnActivity(int activityId) const noexcept
+{
+    return m_activities.isEmpty()
+           || (activityId >= 0 && activityId < m_activitiesMask.size() && m_activitiesMask.testBit(activityId));
+}
+
 inline QRect WindowInfoWrap::geometry() const noexcept
 {
     return m_geometry;
@@ -302,6 +410,16 @@ inline void WindowInfoWrap::setGeometry(const QRect &geometry) noexcept
     m_geometry = geometry;
 }
 
+inline QString WindowInfoWrap::windowClass() const noexcept
+{
+    return m_windowClass;
+}
+
+inline void WindowInfoWrap::setWindowClass(const QString &windowClass) noexcept
+{
+    m_windowClass = windowClass;
+}
+
 inline WindowId WindowInfoWrap::wid() const noexcept
 {
     return m_wid;
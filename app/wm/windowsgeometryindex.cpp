@@ -0,0 +1,144 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "windowsgeometryindex.h"
+
+namespace Latte {
+
+inline int WindowsGeometryIndex::cellFor(int coordinate) const
+{
+    //! floor division in order to support negative coordinates
+    return coordinate >= 0 ? coordinate / CellSize : (coordinate - CellSize + 1) / CellSize;
+}
+
+inline quint64 WindowsGeometryIndex::cellKey(int column, int row) const
+{
+    return (static_cast<quint64>(static_cast<quint32>(column)) << 32) | static_cast<quint32>(row);
+}
+
+inline QRect WindowsGeometryIndex::cellsFor(const QRect &area) const
+{
+    //! windows far away from any screen must not flood the grid
+    const QRect bounded = area.intersected(QRect(-32768, -32768, 65536, 65536));
+
+    return QRect(QPoint(cellFor(bounded.left()), cellFor(bounded.top())),
+                 QPoint(cellFor(bounded.right()), cellFor(bounded.bottom())));
+}
+
+void WindowsGeometryIndex::insert(const WindowId &wid, const QRect &geometry)
+{
+    auto it = m_geometries.constFind(wid);
+
+    if (it != m_geometries.constEnd()) {
+        if (*it == geometry) {
+            return;
+        }
+
+        remove(wid);
+    }
+
+    if (!geometry.isValid()) {
+        return;
+    }
+
+    const QRect cells = cellsFor(geometry);
+
+    if (!cells.isValid()) {
+        return;
+    }
+
+    for (int column = cells.left(); column <= cells.right(); ++column) {
+        for (int row = cells.top(); row <= cells.bottom(); ++row) {
+            m_cells[cellKey(column, row)].append(wid);
+        }
+    }
+
+    m_geometries[wid] = geometry;
+}
+
+void WindowsGeometryIndex::remove(const WindowId &wid)
+{
+    auto it = m_geometries.find(wid);
+
+    if (it == m_geometries.end()) {
+        return;
+    }
+
+    const QRect cells = cellsFor(*it);
+
+    for (int column = cells.left(); column <= cells.right(); ++column) {
+        for (int row = cells.top(); row <= cells.bottom(); ++row) {
+            auto cell = m_cells.find(cellKey(column, row));
+
+            if (cell == m_cells.end()) {
+                continue;
+            }
+
+            cell->removeOne(wid);
+
+            if (cell->isEmpty()) {
+                m_cells.erase(cell);
+            }
+        }
+    }
+
+    m_geometries.erase(it);
+}
+
+void WindowsGeometryIndex::clear()
+{
+    m_cells.clear();
+    m_geometries.clear();
+}
+
+QVector<WindowId> WindowsGeometryIndex::windowsIn(const QRect &area) const
+{
+    QVector<WindowId> windows;
+
+    if (!area.isValid()) {
+        return windows;
+    }
+
+    const QRect cells = cellsFor(area);
+
+    for (int column = cells.left(); column <= cells.right(); ++column) {
+        for (int row = cells.top(); row <= cells.bottom(); ++row) {
+            auto cell = m_cells.constFind(cellKey(column, row));
+
+            if (cell == m_cells.constEnd()) {
+                continue;
+            }
+
+            for (const auto &wid : *cell) {
+                const QRect intersection = m_geometries[wid].intersected(area);
+
+                //! a window spanning many cells is reported only once, from the cell
+                //! that contains the top left corner of its intersection with the area
+                if (!intersection.isEmpty()
+                    && cellFor(intersection.left()) == column && cellFor(intersection.top()) == row) {
+                    windows.append(wid);
+                }
+            }
+        }
+    }
+
+    return windows;
+}
+
+}
@@ -0,0 +1,62 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WINDOWSGEOMETRYINDEX_H
+#define WINDOWSGEOMETRYINDEX_H
+
+// local
+#include "windowinfowrap.h"
+
+// Qt
+#include <QHash>
+#include <QRect>
+#include <QVector>
+
+namespace Latte {
+
+//! A uniform grid over the global screens space that indexes the window geometries.
+//! Views are always snapped to screen edges, so asking for the windows that
+//! overlap their strip touches only a few cells instead of all windows
+class WindowsGeometryIndex
+{
+public:
+    void insert(const WindowId &wid, const QRect &geometry);
+    void remove(const WindowId &wid);
+    void clear();
+
+    //! windows whose geometry intersects the given area
+    QVector<WindowId> windowsIn(const QRect &area) const;
+
+private:
+    static const int CellSize{256};
+
+    inline int cellFor(int coordinate) const;
+    inline quint64 cellKey(int column, int row) const;
+    inline QRect cellsFor(const QRect &area) const;
+
+private:
+    //! grid cell and the windows overlapping it
+    QHash<quint64, QVector<WindowId>> m_cells;
+    //! indexed window and its geometry
+    QHash<WindowId, QRect> m_geometries;
+};
+
+}
+
+#endif
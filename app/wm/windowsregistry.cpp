@@ -0,0 +1,174 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "windowsregistry.h"
+
+namespace Latte {
+
+inline int WindowsRegistry::homeSlot(WindowId wid) const
+{
+    //! fibonacci hashing, window ids are usually sequential
+    return static_cast<int>(static_cast<quint32>(wid * 2654435769u) >> (32 - m_bits));
+}
+
+bool WindowsRegistry::contains(WindowId wid) const
+{
+    return findSlot(wid) >= 0;
+}
+
+bool WindowsRegistry::isEmpty() const
+{
+    return m_windows.empty();
+}
+
+int WindowsRegistry::count() const
+{
+    return static_cast<int>(m_windows.size());
+}
+
+const std::vector<WindowId> &WindowsRegistry::windows() const
+{
+    return m_windows;
+}
+
+int WindowsRegistry::findSlot(WindowId wid) const
+{
+    if (m_slots.empty()) {
+        return -1;
+    }
+
+    const int mask = static_cast<int>(m_slots.size()) - 1;
+
+    for (int slot = homeSlot(wid); m_slots[slot] >= 0; slot = (slot + 1) & mask) {
+        if (m_windows[m_slots[slot]] == wid) {
+            return slot;
+        }
+    }
+
+    return -1;
+}
+
+int WindowsRegistry::indexOf(WindowId wid) const
+{
+    const int slot = findSlot(wid);
+
+    return slot >= 0 ? m_slots[slot] : -1;
+}
+
+void WindowsRegistry::rehash(int bits)
+{
+    m_bits = bits;
+    m_slots.assign(static_cast<size_t>(1) << bits, -1);
+
+    const int mask = static_cast<int>(m_slots.size()) - 1;
+
+    for (int pos = 0; pos < count(); ++pos) {
+        int slot = homeSlot(m_windows[pos]);
+
+        while (m_slots[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+
+        m_slots[slot] = pos;
+    }
+}
+
+int WindowsRegistry::insert(WindowId wid)
+{
+    const int existing = indexOf(wid);
+
+    if (existing >= 0) {
+        return existing;
+    }
+
+    //! keep the load factor under 50% so probing sequences stay short
+    if (m_slots.empty() || (count() + 1) * 2 > static_cast<int>(m_slots.size())) {
+        rehash(qMax(MinimumBits, m_bits + 1));
+    }
+
+    const int mask = static_cast<int>(m_slots.size()) - 1;
+    int slot = homeSlot(wid);
+
+    while (m_slots[slot] >= 0) {
+        slot = (slot + 1) & mask;
+    }
+
+    const int pos = count();
+    m_windows.push_back(wid);
+    m_slots[slot] = pos;
+
+    return pos;
+}
+
+int WindowsRegistry::remove(WindowId wid)
+{
+    int slot = findSlot(wid);
+
+    if (slot < 0) {
+        return -1;
+    }
+
+    //! keep the windows packed by moving the last one in the removed position
+    const int pos = m_slots[slot];
+    const int last = count() - 1;
+
+    if (pos != last) {
+        const WindowId lastWid = m_windows[last];
+        m_slots[findSlot(lastWid)] = pos;
+        m_windows[pos] = lastWid;
+    }
+
+    m_windows.pop_back();
+
+    //! backward shift deletion, no tombstones are needed for linear probing
+    const int mask = static_cast<int>(m_slots.size()) - 1;
+    int next = slot;
+
+    m_slots[slot] = -1;
+
+    while (true) {
+        next = (next + 1) & mask;
+
+        if (m_slots[next] < 0) {
+            break;
+        }
+
+        const int home = homeSlot(m_windows[m_slots[next]]);
+
+        //! the window stays when its home slot is cyclically inside (slot, next]
+        const bool stays = (slot <= next) ? (slot < home && home <= next) : (slot < home || home <= next);
+
+        if (!stays) {
+            m_slots[slot] = m_slots[next];
+            m_slots[next] = -1;
+            slot = next;
+        }
+    }
+
+    return pos;
+}
+
+void WindowsRegistry::clear()
+{
+    m_bits = 0;
+    m_slots.clear();
+    m_windows.clear();
+}
+
+}
@@ -0,0 +1,71 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WINDOWSREGISTRY_H
+#define WINDOWSREGISTRY_H
+
+// local
+#include "windowinfowrap.h"
+
+// C++
+#include <vector>
+
+namespace Latte {
+
+//! A dense windows registry, an open addressing hash table with linear probing
+//! maps each window id to its position in a packed vector that is used for iteration.
+//! Removing a window moves the last window in its position, so the registry can be
+//! used as the index of any other packed storage that mirrors these moves.
+class WindowsRegistry
+{
+public:
+    bool contains(WindowId wid) const;
+    bool isEmpty() const;
+    int count() const;
+
+    //! packed position of the window, -1 when it is not registered
+    int indexOf(WindowId wid) const;
+
+    //! returns the packed position of the window
+    int insert(WindowId wid);
+    //! returns the packed position the window occupied, -1 when it was not registered;
+    //! the last window of the packed vector is moved into that position
+    int remove(WindowId wid);
+    void clear();
+
+    const std::vector<WindowId> &windows() const;
+
+private:
+    inline int homeSlot(WindowId wid) const;
+    int findSlot(WindowId wid) const;
+    void rehash(int bits);
+
+private:
+    static const int MinimumBits{5};
+
+    int m_bits{0};
+
+    //! each slot holds a packed position or -1 when it is empty
+    std::vector<int> m_slots;
+    std::vector<WindowId> m_windows;
+};
+
+}
+
+#endif
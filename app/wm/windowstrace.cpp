@@ -0,0 +1,130 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "windowstrace.h"
+
+// Qt
+#include <QDebug>
+#include <QGuiApplication>
+#include <QScreen>
+
+namespace Latte {
+
+//! BEGIN: WindowsTraceRecorder
+WindowsTraceRecorder::WindowsTraceRecorder(AbstractWindowInterface *wm, const QString &file, QObject *parent)
+    : QObject(parent),
+      m_file(file),
+      m_wm(wm)
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "windows trace: file" << file << "can not be written...";
+        return;
+    }
+
+    m_stream.setDevice(&m_file);
+    m_stream.setVersion(QDataStream::Qt_5_6);
+
+    //! the trace must contain the windows of all the screens
+    if (qGuiApp->primaryScreen()) {
+        m_wm->setInterest(this, qGuiApp->primaryScreen()->virtualGeometry());
+    }
+
+    m_stream << WindowsTrace::Magic << WindowsTrace::Version << m_wm->currentActivity();
+
+    m_time.start();
+
+    //! the windows that exist already when the recording starts
+    for (const auto &winfo : m_wm->windowsInfo()) {
+        writeEvent(WindowsTrace::WindowAddedEvent);
+        writeWindow(winfo.wid());
+    }
+
+    writeEvent(WindowsTrace::ActiveWindowChangedEvent);
+    m_stream << m_wm->activeWindow();
+
+    writeEvent(WindowsTrace::CurrentDesktopChangedEvent);
+    m_stream << static_cast<qint32>(m_wm->currentDesktop());
+
+    //! the window states cache is already updated for all these signals
+    connect(m_wm, &AbstractWindowInterface::windowAdded, this, [&](WindowId wid) {
+        if (m_wm->hasWindowInfo(wid)) {
+            writeEvent(WindowsTrace::WindowAddedEvent);
+            writeWindow(wid);
+        }
+    });
+
+    connect(m_wm, &AbstractWindowInterface::windowRemoved, this, [&](WindowId wid) {
+        writeEvent(WindowsTrace::WindowRemovedEvent);
+        m_stream << wid;
+    });
+
+    connect(m_wm, &AbstractWindowInterface::windowsChanged, this
+    , [&](const QHash<WindowId, AbstractWindowInterface::ChangedProperties> &changes) {
+        for (auto it = changes.constBegin(); it != changes.constEnd(); ++it) {
+            if (m_wm->hasWindowInfo(it.key())) {
+                writeEvent(WindowsTrace::WindowChangedEvent);
+                m_stream << static_cast<quint8>(it.value());
+                writeWindow(it.key());
+            }
+        }
+    });
+
+    connect(m_wm, &AbstractWindowInterface::activeWindowChanged, this, [&](WindowId wid) {
+        writeEvent(WindowsTrace::ActiveWindowChangedEvent);
+        m_stream << wid;
+    });
+
+    connect(m_wm, &AbstractWindowInterface::currentDesktopChanged, this, [&]() {
+        writeEvent(WindowsTrace::CurrentDesktopChangedEvent);
+        m_stream << static_cast<qint32>(m_wm->currentDesktop());
+    });
+}
+
+WindowsTraceRecorder::~WindowsTraceRecorder()
+{
+    m_file.close();
+}
+
+void WindowsTraceRecorder::writeEvent(quint8 type)
+{
+    m_stream << type << static_cast<qint64>(m_time.elapsed());
+}
+
+void WindowsTraceRecorder::writeWindow(WindowId wid)
+{
+    const WindowInfoWrap &winfo = m_wm->windowInfo(wid);
+
+    quint16 flags{0};
+    flags |= winfo.isValid() ? WindowsTrace::ValidFlag : 0;
+    flags |= winfo.isActive() ? WindowsTrace::ActiveFlag : 0;
+    flags |= winfo.isMinimized() ? WindowsTrace::MinimizedFlag : 0;
+    flags |= winfo.isMaxVert() ? WindowsTrace::MaxVertFlag : 0;
+    flags |= winfo.isMaxHoriz() ? WindowsTrace::MaxHorizFlag : 0;
+    flags |= winfo.isFullscreen() ? WindowsTrace::FullscreenFlag : 0;
+    flags |= winfo.isShaded() ? WindowsTrace::ShadedFlag : 0;
+    flags |= winfo.isPlasmaDesktop() ? WindowsTrace::PlasmaDesktopFlag : 0;
+    flags |= winfo.isKeepAbove() ? WindowsTrace::KeepAboveFlag : 0;
+    flags |= winfo.hasSkipTaskbar() ? WindowsTrace::SkipTaskbarFlag : 0;
+    flags |= winfo.isOnAllDesktops() ? WindowsTrace::OnAllDesktopsFlag : 0;
+
+    m_stream << wid << flags << winfo.geometry() << static_cast<qint32>(winfo.desktop()) << winfo.activities();
+}
+//! END: WindowsTraceRecorder
+
+}
@@ -0,0 +1,92 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WINDOWSTRACE_H
+#define WINDOWSTRACE_H
+
+// local
+#include "abstractwindowinterface.h"
+#include "windowinfowrap.h"
+
+// Qt
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QObject>
+
+namespace Latte {
+
+//! the binary trace format, shared by the recorder and the player
+namespace WindowsTrace {
+
+const quint32 Magic{0x4c575452}; //! "LWTR"
+const quint16 Version{1};
+
+enum Event
+{
+    WindowAddedEvent = 0,
+    WindowRemovedEvent,
+    WindowChangedEvent,
+    ActiveWindowChangedEvent,
+    CurrentDesktopChangedEvent
+};
+
+enum WindowFlag
+{
+    ValidFlag = 1,
+    ActiveFlag = 1 << 1,
+    MinimizedFlag = 1 << 2,
+    MaxVertFlag = 1 << 3,
+    MaxHorizFlag = 1 << 4,
+    FullscreenFlag = 1 << 5,
+    ShadedFlag = 1 << 6,
+    PlasmaDesktopFlag = 1 << 7,
+    KeepAboveFlag = 1 << 8,
+    SkipTaskbarFlag = 1 << 9,
+    OnAllDesktopsFlag = 1 << 10
+};
+
+}
+
+//! Developers tools, the window manager events are written with their timestamp
+//! and their payload in a compact binary trace that can be replayed afterwards
+//! through the synthetic window tracking, without a live window manager session.
+class WindowsTraceRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    WindowsTraceRecorder(AbstractWindowInterface *wm, const QString &file, QObject *parent = nullptr);
+    ~WindowsTraceRecorder() override;
+
+private:
+    void writeEvent(quint8 type);
+    void writeWindow(WindowId wid);
+
+private:
+    QElapsedTimer m_time;
+    QFile m_file;
+    QDataStream m_stream;
+
+    AbstractWindowInterface *m_wm{nullptr};
+};
+
+}
+
+#endif
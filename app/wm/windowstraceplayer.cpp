@@ -0,0 +1,236 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "windowstraceplayer.h"
+
+// local
+#include "syntheticwindowinterface.h"
+#include "windowstrace.h"
+
+// Qt
+#include <QDebug>
+#include <QFile>
+#include <QGuiApplication>
+
+namespace Latte {
+
+//! BEGIN: WindowsTracePlayer
+WindowsTracePlayer::WindowsTracePlayer(SyntheticWindowInterface *wm, const QString &file, QObject *parent)
+    : QObject(parent),
+      m_wm(wm)
+{
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &WindowsTracePlayer::playEvents);
+
+    //! the whole trace is loaded upfront, that way file reading is not part of the replay
+    if (!load(file)) {
+        qWarning() << "windows trace: file" << file << "is not a valid windows trace...";
+        m_events.clear();
+    }
+
+    adoptActivity();
+}
+
+WindowsTracePlayer::~WindowsTracePlayer()
+{
+}
+
+bool WindowsTracePlayer::load(const QString &file)
+{
+    QFile traceFile(file);
+
+    if (!traceFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&traceFile);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic;
+    quint16 version;
+    stream >> magic >> version >> m_activity;
+
+    if (magic != WindowsTrace::Magic || version != WindowsTrace::Version) {
+        return false;
+    }
+
+    while (!stream.atEnd()) {
+        Event event{0, 0, 0, 0, WindowInfoWrap()};
+        stream >> event.type >> event.time;
+
+        WindowId wid{0};
+        quint16 flags{0};
+        QRect geometry;
+        qint32 desktop{0};
+        QStringList activities;
+
+        switch (event.type) {
+            case WindowsTrace::WindowChangedEvent:
+                stream >> event.properties;
+                Q_FALLTHROUGH();
+
+            case WindowsTrace::WindowAddedEvent:
+                stream >> wid >> flags >> geometry >> desktop >> activities;
+
+                event.winfo.setWid(wid);
+                event.winfo.setIsValid(flags & WindowsTrace::ValidFlag);
+                event.winfo.setIsActive(flags & WindowsTrace::ActiveFlag);
+                event.winfo.setIsMinimized(flags & WindowsTrace::MinimizedFlag);
+                event.winfo.setIsMaxVert(flags & WindowsTrace::MaxVertFlag);
+                event.winfo.setIsMaxHoriz(flags & WindowsTrace::MaxHorizFlag);
+                event.winfo.setIsFullscreen(flags & WindowsTrace::FullscreenFlag);
+                event.winfo.setIsShaded(flags & WindowsTrace::ShadedFlag);
+                event.winfo.setIsPlasmaDesktop(flags & WindowsTrace::PlasmaDesktopFlag);
+                event.winfo.setIsKeepAbove(flags & WindowsTrace::KeepAboveFlag);
+                event.winfo.setHasSkipTaskbar(flags & WindowsTrace::SkipTaskbarFlag);
+                event.winfo.setIsOnAllDesktops(flags & WindowsTrace::OnAllDesktopsFlag);
+                event.winfo.setGeometry(geometry);
+                event.winfo.setDesktop(desktop);
+                event.winfo.setActivities(activities);
+                break;
+
+            case WindowsTrace::WindowRemovedEvent:
+            case WindowsTrace::ActiveWindowChangedEvent:
+                stream >> wid;
+                event.winfo.setWid(wid);
+                break;
+
+            case WindowsTrace::CurrentDesktopChangedEvent:
+                stream >> event.desktop;
+                break;
+
+            default:
+                return false;
+        }
+
+        if (stream.status() != QDataStream::Ok) {
+            return false;
+        }
+
+        m_events.push_back(event);
+    }
+
+    return true;
+}
+
+bool WindowsTracePlayer::isTrace(const QString &file)
+{
+    QFile traceFile(file);
+
+    if (!traceFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&traceFile);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic;
+    quint16 version;
+    stream >> magic >> version;
+
+    return stream.status() == QDataStream::Ok && magic == WindowsTrace::Magic && version == WindowsTrace::Version;
+}
+
+void WindowsTracePlayer::adoptActivity()
+{
+    //! the recorded current activity becomes the current activity of this session
+    const QString activity = m_wm->currentActivity();
+
+    for (auto &event : m_events) {
+        QStringList activities = event.winfo.activities();
+
+        if (!activities.isEmpty() && activities.contains(m_activity)) {
+            activities.replaceInStrings(m_activity, activity);
+            event.winfo.setActivities(activities);
+        }
+    }
+}
+
+void WindowsTracePlayer::start()
+{
+    if (m_events.empty()) {
+        qWarning() << "windows trace: there are no events to replay...";
+        return;
+    }
+
+    qInfo() << "windows trace: replaying" << m_events.size() << "events...";
+
+    //! the views must have been loaded and their startup phase must have ended
+    QTimer::singleShot(StartupDelay, this, [&]() {
+        m_time.start();
+        playEvents();
+    });
+}
+
+void WindowsTracePlayer::playEvents()
+{
+    //! events are replayed with their recorded timing, the visibility timers
+    //! depend on it
+    while (m_next < m_events.size() && m_events[m_next].time <= m_time.elapsed()) {
+        playNextEvent();
+    }
+
+    if (m_next < m_events.size()) {
+        m_timer.start(static_cast<int>(qMax<qint64>(0, m_events[m_next].time - m_time.elapsed())));
+    } else {
+        qInfo() << "windows trace: replay finished in" << m_time.elapsed() << "ms";
+        qGuiApp->exit();
+    }
+}
+
+bool WindowsTracePlayer::playNextEvent()
+{
+    if (m_next >= m_events.size()) {
+        return false;
+    }
+
+    const Event &event = m_events[m_next];
+
+    switch (event.type) {
+        case WindowsTrace::WindowAddedEvent:
+            m_wm->addWindow(event.winfo);
+            break;
+
+        case WindowsTrace::WindowRemovedEvent:
+            m_wm->removeWindow(event.winfo.wid());
+            break;
+
+        case WindowsTrace::WindowChangedEvent:
+            m_wm->changeWindow(event.winfo, AbstractWindowInterface::ChangedProperties(QFlag(event.properties)));
+            break;
+
+        case WindowsTrace::ActiveWindowChangedEvent:
+            m_wm->setActiveWindow(event.winfo.wid());
+            break;
+
+        case WindowsTrace::CurrentDesktopChangedEvent:
+            m_wm->setCurrentDesktop(event.desktop);
+            break;
+
+        default:
+            break;
+    }
+
+    ++m_next;
+
+    return true;
+}
+//! END: WindowsTracePlayer
+
+}
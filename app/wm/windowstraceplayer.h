@@ -0,0 +1,91 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef WINDOWSTRACEPLAYER_H
+#define WINDOWSTRACEPLAYER_H
+
+// local
+#include "windowinfowrap.h"
+
+// C++
+#include <vector>
+
+// Qt
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+namespace Latte {
+class SyntheticWindowInterface;
+}
+
+namespace Latte {
+
+//! Developers tools, a recorded windows trace is replayed through the synthetic
+//! window tracking with its recorded timing
+class WindowsTracePlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    WindowsTracePlayer(SyntheticWindowInterface *wm, const QString &file, QObject *parent = nullptr);
+    ~WindowsTracePlayer() override;
+
+    //! replays the events with their recorded timing and exits at the end
+    void start();
+
+    //! the next event is replayed immediately, it returns false when
+    //! all the events have been replayed
+    bool playNextEvent();
+
+    //! it checks only the trace header, in order to fall back to the real
+    //! windows tracking before any view is created
+    static bool isTrace(const QString &file);
+
+private:
+    struct Event {
+        quint8 type;
+        qint64 time;
+        qint32 desktop;
+        quint8 properties;
+        WindowInfoWrap winfo;
+    };
+
+    bool load(const QString &file);
+    void adoptActivity();
+    void playEvents();
+
+private:
+    static const int StartupDelay{10000};
+
+    size_t m_next{0};
+
+    //! the current activity of the recorded session
+    QString m_activity;
+    std::vector<Event> m_events;
+
+    QElapsedTimer m_time;
+    QTimer m_timer;
+
+    SyntheticWindowInterface *m_wm{nullptr};
+};
+
+}
+
+#endif
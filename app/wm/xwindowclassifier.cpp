@@ -0,0 +1,347 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "xwindowclassifier.h"
+
+// C++
+#include <algorithm>
+
+// Qt
+#include <QDebug>
+#include <QScopedPointer>
+
+namespace Latte {
+
+//! BEGIN: XWindowInfoReader
+XWindowInfoReader::XWindowInfoReader(xcb_connection_t *connection, xcb_window_t rootWindow)
+    : m_connection(connection),
+      m_rootWindow(rootWindow)
+{
+    initAtoms();
+}
+
+void XWindowInfoReader::initAtoms()
+{
+    static const std::array<QByteArray, AtomsCount> atomNames{{
+            QByteArrayLiteral("_NET_WM_STATE"),
+            QByteArrayLiteral("_NET_WM_STATE_HIDDEN"),
+            QByteArrayLiteral("_NET_WM_STATE_MAXIMIZED_VERT"),
+            QByteArrayLiteral("_NET_WM_STATE_MAXIMIZED_HORZ"),
+            QByteArrayLiteral("_NET_WM_STATE_FULLSCREEN"),
+            QByteArrayLiteral("_NET_WM_STATE_SHADED"),
+            QByteArrayLiteral("_NET_WM_STATE_ABOVE"),
+            QByteArrayLiteral("_NET_WM_STATE_SKIP_TASKBAR"),
+            QByteArrayLiteral("_NET_WM_WINDOW_TYPE"),
+            QByteArrayLiteral("_NET_WM_WINDOW_TYPE_NORMAL"),
+            QByteArrayLiteral("_NET_WM_WINDOW_TYPE_DESKTOP"),
+            QByteArrayLiteral("_NET_WM_WINDOW_TYPE_DOCK"),
+            QByteArrayLiteral("_NET_WM_WINDOW_TYPE_MENU"),
+            QByteArrayLiteral("_NET_WM_WINDOW_TYPE_SPLASH"),
+            QByteArrayLiteral("_NET_WM_DESKTOP"),
+            QByteArrayLiteral("_NET_FRAME_EXTENTS"),
+            QByteArrayLiteral("_KDE_NET_WM_ACTIVITIES")
+        }};
+
+    std::array<xcb_intern_atom_cookie_t, AtomsCount> cookies;
+
+    for (int i = 0; i < AtomsCount; ++i) {
+        cookies[i] = xcb_intern_atom_unchecked(m_connection, false, atomNames[i].length(), atomNames[i].constData());
+    }
+
+    for (int i = 0; i < AtomsCount; ++i) {
+        QScopedPointer<xcb_intern_atom_reply_t, QScopedPointerPodDeleter> atom(xcb_intern_atom_reply(m_connection, cookies[i], nullptr));
+        m_atoms[i] = atom ? atom->atom : static_cast<xcb_atom_t>(XCB_ATOM_NONE);
+    }
+}
+
+std::vector<WindowInfoWrap> XWindowInfoReader::read(const std::vector<WindowId> &wids, WindowId activeWindow) const
+{
+    struct Cookies {
+        xcb_get_geometry_cookie_t geometry;
+        xcb_translate_coordinates_cookie_t position;
+        xcb_get_property_cookie_t frameExtents;
+        xcb_get_property_cookie_t state;
+        xcb_get_property_cookie_t type;
+        xcb_get_property_cookie_t desktop;
+        xcb_get_property_cookie_t activities;
+        xcb_get_property_cookie_t windowClass;
+    };
+
+    xcb_connection_t *c = m_connection;
+
+    std::vector<Cookies> cookies;
+    cookies.reserve(wids.size());
+
+    //! all the requests are sent first and their replies are collected afterwards,
+    //! that way the entire batch costs just one round trip to the X server
+    for (const auto &wid : wids) {
+        const xcb_window_t window = static_cast<xcb_window_t>(wid);
+
+        Cookies cookie;
+        cookie.geometry = xcb_get_geometry(c, window);
+        cookie.position = xcb_translate_coordinates(c, window, m_rootWindow, 0, 0);
+        cookie.frameExtents = xcb_get_property(c, false, window, m_atoms[NetFrameExtents], XCB_ATOM_CARDINAL, 0, 4);
+        cookie.state = xcb_get_property(c, false, window, m_atoms[NetWmState], XCB_ATOM_ATOM, 0, 2048);
+        cookie.type = xcb_get_property(c, false, window, m_atoms[NetWmWindowType], XCB_ATOM_ATOM, 0, 2048);
+        cookie.desktop = xcb_get_property(c, false, window, m_atoms[NetWmDesktop], XCB_ATOM_CARDINAL, 0, 1);
+        cookie.activities = xcb_get_property(c, false, window, m_atoms[KdeNetWmActivities], XCB_ATOM_STRING, 0, 2048);
+        cookie.windowClass = xcb_get_property(c, false, window, XCB_ATOM_WM_CLASS, XCB_ATOM_STRING, 0, 2048);
+        cookies.push_back(cookie);
+    }
+
+    using PropertyReply = QScopedPointer<xcb_get_property_reply_t, QScopedPointerPodDeleter>;
+
+    auto atomsFrom = [](const PropertyReply &reply) -> std::vector<xcb_atom_t> {
+        if (!reply || reply->type != XCB_ATOM_ATOM || reply->format != 32) {
+            return {};
+        }
+
+        const xcb_atom_t *atoms = reinterpret_cast<const xcb_atom_t *>(xcb_get_property_value(reply.data()));
+        const int length = xcb_get_property_value_length(reply.data()) / sizeof(xcb_atom_t);
+
+        return std::vector<xcb_atom_t>(atoms, atoms + length);
+    };
+
+    auto cardinalsFrom = [](const PropertyReply &reply) -> std::vector<uint32_t> {
+        if (!reply || reply->type != XCB_ATOM_CARDINAL || reply->format != 32) {
+            return {};
+        }
+
+        const uint32_t *values = reinterpret_cast<const uint32_t *>(xcb_get_property_value(reply.data()));
+        const int length = xcb_get_property_value_length(reply.data()) / sizeof(uint32_t);
+
+        return std::vector<uint32_t>(values, values + length);
+    };
+
+    std::vector<WindowInfoWrap> infos;
+    infos.reserve(wids.size());
+
+    for (size_t i = 0; i < wids.size(); ++i) {
+        const WindowId &wid = wids[i];
+
+        QScopedPointer<xcb_get_geometry_reply_t, QScopedPointerPodDeleter>
+        geometry(xcb_get_geometry_reply(c, cookies[i].geometry, nullptr));
+        QScopedPointer<xcb_translate_coordinates_reply_t, QScopedPointerPodDeleter>
+        position(xcb_translate_coordinates_reply(c, cookies[i].position, nullptr));
+        PropertyReply frameExtents(xcb_get_property_reply(c, cookies[i].frameExtents, nullptr));
+        PropertyReply state(xcb_get_property_reply(c, cookies[i].state, nullptr));
+        PropertyReply type(xcb_get_property_reply(c, cookies[i].type, nullptr));
+        PropertyReply desktop(xcb_get_property_reply(c, cookies[i].desktop, nullptr));
+        PropertyReply activities(xcb_get_property_reply(c, cookies[i].activities, nullptr));
+        PropertyReply windowClass(xcb_get_property_reply(c, cookies[i].windowClass, nullptr));
+
+        WindowInfoWrap winfoWrap;
+
+        //! the window does not exist any more
+        if (!geometry || !position) {
+            infos.push_back(winfoWrap);
+            continue;
+        }
+
+        const std::vector<xcb_atom_t> types = atomsFrom(type);
+
+        if (isDesktopWindow(types)) {
+            winfoWrap.setIsValid(true);
+            winfoWrap.setIsPlasmaDesktop(true);
+            winfoWrap.setWid(wid);
+            winfoWrap.setHasSkipTaskbar(true);
+        } else if (isValidWindow(types)) {
+            const std::vector<xcb_atom_t> states = atomsFrom(state);
+
+            auto hasState = [&](Atom atom) {
+                return std::find(states.cbegin(), states.cend(), m_atoms[atom]) != states.cend();
+            };
+
+            winfoWrap.setIsValid(true);
+            winfoWrap.setWid(wid);
+            winfoWrap.setIsActive(activeWindow == wid);
+            winfoWrap.setIsMinimized(hasState(NetWmStateHidden));
+            winfoWrap.setIsMaxVert(hasState(NetWmStateMaxVert));
+            winfoWrap.setIsMaxHoriz(hasState(NetWmStateMaxHoriz));
+            winfoWrap.setIsFullscreen(hasState(NetWmStateFullScreen));
+            winfoWrap.setIsShaded(hasState(NetWmStateShaded));
+            winfoWrap.setGeometry(frameGeometry(geometry.data(), position.data(), frameExtents.data()));
+            winfoWrap.setIsKeepAbove(hasState(NetWmStateAbove));
+            winfoWrap.setHasSkipTaskbar(hasState(NetWmStateSkipTaskbar));
+
+            //! WM_CLASS holds the instance name and the class name, both null terminated
+            if (windowClass && windowClass->format == 8) {
+                const QByteArray names(reinterpret_cast<const char *>(xcb_get_property_value(windowClass.data())),
+                                       xcb_get_property_value_length(windowClass.data()));
+                const QList<QByteArray> parts = names.split('\0');
+
+                if (parts.size() > 1) {
+                    winfoWrap.setWindowClass(QString::fromLocal8Bit(parts[1]));
+                }
+            }
+        }
+
+        //! desktop is counted from 1 like KWindowSystem does and 0xFFFFFFFF means all desktops
+        const std::vector<uint32_t> desktopValue = cardinalsFrom(desktop);
+
+        if (!desktopValue.empty()) {
+            winfoWrap.setIsOnAllDesktops(desktopValue[0] == 0xFFFFFFFF);
+            winfoWrap.setDesktop(desktopValue[0] == 0xFFFFFFFF ? -1 : static_cast<int>(desktopValue[0]) + 1);
+        }
+
+        if (activities && activities->format == 8) {
+            const QString activitiesStr = QString::fromUtf8(reinterpret_cast<const char *>(xcb_get_property_value(activities.data())),
+                                                            xcb_get_property_value_length(activities.data()));
+
+            //! the null uuid is used for windows shown in all activities
+            if (activitiesStr != QLatin1String("00000000-0000-0000-0000-000000000000")) {
+                winfoWrap.setActivities(activitiesStr.split(QLatin1Char(','), QString::SkipEmptyParts));
+            }
+        }
+
+        infos.push_back(winfoWrap);
+    }
+
+    return infos;
+}
+
+std::vector<QRect> XWindowInfoReader::readGeometries(const std::vector<WindowId> &wids) const
+{
+    struct Cookies {
+        xcb_get_geometry_cookie_t geometry;
+        xcb_translate_coordinates_cookie_t position;
+        xcb_get_property_cookie_t frameExtents;
+    };
+
+    xcb_connection_t *c = m_connection;
+
+    std::vector<Cookies> cookies;
+    cookies.reserve(wids.size());
+
+    for (const auto &wid : wids) {
+        const xcb_window_t window = static_cast<xcb_window_t>(wid);
+
+        Cookies cookie;
+        cookie.geometry = xcb_get_geometry(c, window);
+        cookie.position = xcb_translate_coordinates(c, window, m_rootWindow, 0, 0);
+        cookie.frameExtents = xcb_get_property(c, false, window, m_atoms[NetFrameExtents], XCB_ATOM_CARDINAL, 0, 4);
+        cookies.push_back(cookie);
+    }
+
+    std::vector<QRect> geometries;
+    geometries.reserve(wids.size());
+
+    for (size_t i = 0; i < wids.size(); ++i) {
+        QScopedPointer<xcb_get_geometry_reply_t, QScopedPointerPodDeleter>
+        geometry(xcb_get_geometry_reply(c, cookies[i].geometry, nullptr));
+        QScopedPointer<xcb_translate_coordinates_reply_t, QScopedPointerPodDeleter>
+        position(xcb_translate_coordinates_reply(c, cookies[i].position, nullptr));
+        QScopedPointer<xcb_get_property_reply_t, QScopedPointerPodDeleter>
+        frameExtents(xcb_get_property_reply(c, cookies[i].frameExtents, nullptr));
+
+        if (!geometry || !position) {
+            geometries.push_back(QRect());
+            continue;
+        }
+
+        geometries.push_back(frameGeometry(geometry.data(), position.data(), frameExtents.data()));
+    }
+
+    return geometries;
+}
+
+QRect XWindowInfoReader::frameGeometry(const xcb_get_geometry_reply_t *geometry, const xcb_translate_coordinates_reply_t *position
+                                       , xcb_get_property_reply_t *frameExtents) const
+{
+    //! frame extents order is left, right, top, bottom
+    std::array<int, 4> extents{{0, 0, 0, 0}};
+
+    if (frameExtents && frameExtents->type == XCB_ATOM_CARDINAL && frameExtents->format == 32) {
+        const uint32_t *values = reinterpret_cast<const uint32_t *>(xcb_get_property_value(frameExtents));
+        const int length = std::min(4, static_cast<int>(xcb_get_property_value_length(frameExtents) / sizeof(uint32_t)));
+
+        for (int i = 0; i < length; ++i) {
+            extents[i] = static_cast<int>(values[i]);
+        }
+    }
+
+    return QRect(position->dst_x - extents[0],
+                 position->dst_y - extents[2],
+                 geometry->width + extents[0] + extents[1],
+                 geometry->height + extents[2] + extents[3]);
+}
+
+bool XWindowInfoReader::isDesktopWindow(const std::vector<xcb_atom_t> &types) const
+{
+    return std::find(types.cbegin(), types.cend(), m_atoms[NetWmWindowTypeDesktop]) != types.cend();
+}
+
+bool XWindowInfoReader::isValidWindow(const std::vector<xcb_atom_t> &types) const
+{
+    //! the first of the Dock, Menu, Splash and Normal types found in the window types
+    //! is the one that counts, windows with any other type or with no type at all
+    //! are assumed as NET::Normal
+    for (const auto &type : types) {
+        if (type == m_atoms[NetWmWindowTypeNormal]) {
+            return true;
+        } else if (type == m_atoms[NetWmWindowTypeDock]
+                   || type == m_atoms[NetWmWindowTypeMenu]
+                   || type == m_atoms[NetWmWindowTypeSplash]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+//! END: XWindowInfoReader
+
+//! BEGIN: XWindowClassifier
+XWindowClassifier::XWindowClassifier()
+    : QObject(nullptr)
+{
+    m_connection = xcb_connect(nullptr, &m_screen);
+
+    if (xcb_connection_has_error(m_connection)) {
+        qWarning() << "windows classifier: connection to the X server failed...";
+    }
+}
+
+XWindowClassifier::~XWindowClassifier()
+{
+    m_reader.reset();
+    xcb_disconnect(m_connection);
+}
+
+bool XWindowClassifier::isValid() const
+{
+    return xcb_connection_has_error(m_connection) == 0;
+}
+
+void XWindowClassifier::classify(const std::vector<WindowId> &wids, WindowId activeWindow)
+{
+    if (!m_reader) {
+        xcb_screen_iterator_t screens = xcb_setup_roots_iterator(xcb_get_setup(m_connection));
+
+        for (int i = 0; i < m_screen && screens.rem > 0; ++i) {
+            xcb_screen_next(&screens);
+        }
+
+        m_reader.reset(new XWindowInfoReader(m_connection, screens.data->root));
+    }
+
+    emit windowsClassified(wids, m_reader->read(wids, activeWindow));
+}
+//! END: XWindowClassifier
+
+}
@@ -0,0 +1,123 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef XWINDOWCLASSIFIER_H
+#define XWINDOWCLASSIFIER_H
+
+// local
+#include "windowinfowrap.h"
+
+// C++
+#include <array>
+#include <memory>
+#include <vector>
+
+// Qt
+#include <QMetaType>
+#include <QObject>
+#include <QRect>
+
+// X11
+#include <xcb/xcb.h>
+
+namespace Latte {
+
+//! Reads and classifies the window states of an xcb connection, all the requests
+//! of a batch are pipelined so the batch costs a single round trip to the X server
+class XWindowInfoReader
+{
+public:
+    XWindowInfoReader(xcb_connection_t *connection, xcb_window_t rootWindow);
+
+    //! windows of desktop type are marked as the plasma desktop
+    std::vector<WindowInfoWrap> read(const std::vector<WindowId> &wids, WindowId activeWindow) const;
+    //! only the frame geometries, a null rect is returned for windows that do not exist any more
+    std::vector<QRect> readGeometries(const std::vector<WindowId> &wids) const;
+
+private:
+    enum Atom
+    {
+        NetWmState = 0,
+        NetWmStateHidden,
+        NetWmStateMaxVert,
+        NetWmStateMaxHoriz,
+        NetWmStateFullScreen,
+        NetWmStateShaded,
+        NetWmStateAbove,
+        NetWmStateSkipTaskbar,
+        NetWmWindowType,
+        NetWmWindowTypeNormal,
+        NetWmWindowTypeDesktop,
+        NetWmWindowTypeDock,
+        NetWmWindowTypeMenu,
+        NetWmWindowTypeSplash,
+        NetWmDesktop,
+        NetFrameExtents,
+        KdeNetWmActivities,
+        AtomsCount
+    };
+
+    void initAtoms();
+    bool isDesktopWindow(const std::vector<xcb_atom_t> &types) const;
+    bool isValidWindow(const std::vector<xcb_atom_t> &types) const;
+
+    QRect frameGeometry(const xcb_get_geometry_reply_t *geometry, const xcb_translate_coordinates_reply_t *position
+                        , xcb_get_property_reply_t *frameExtents) const;
+
+private:
+    xcb_connection_t *m_connection{nullptr};
+    xcb_window_t m_rootWindow{XCB_WINDOW_NONE};
+
+    std::array<xcb_atom_t, AtomsCount> m_atoms;
+};
+
+//! Classifies new windows in a worker thread through its own xcb connection,
+//! that way bursts of new windows e.g. at session start do not block painting.
+//! It must be moved to its thread after its creation.
+class XWindowClassifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    XWindowClassifier();
+    ~XWindowClassifier() override;
+
+    //! the own connection to the X server could be established
+    bool isValid() const;
+
+public slots:
+    void classify(const std::vector<Latte::WindowId> &wids, Latte::WindowId activeWindow);
+
+signals:
+    void windowsClassified(const std::vector<Latte::WindowId> &wids, const std::vector<Latte::WindowInfoWrap> &infos);
+
+private:
+    int m_screen{0};
+    xcb_connection_t *m_connection{nullptr};
+
+    //! created in the worker thread with the first batch
+    std::unique_ptr<XWindowInfoReader> m_reader;
+};
+
+}
+
+Q_DECLARE_METATYPE(std::vector<Latte::WindowId>)
+Q_DECLARE_METATYPE(std::vector<Latte::WindowInfoWrap>)
+
+#endif
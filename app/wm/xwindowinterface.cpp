@@ -27,6 +27,7 @@
 
 // Qt
 #include <QDebug>
+#include <QGuiApplication>
 #include <QTimer>
 #include <QtX11Extras/QX11Info>
 
@@ -41,8 +42,35 @@
 namespace Latte {
 
 XWindowInterface::XWindowInterface(QObject *parent)
-    : AbstractWindowInterface(parent)
+    : AbstractWindowInterface(parent),
+      m_reader(QX11Info::connection(), QX11Info::appRootWindow())
 {
+    qRegisterMetaType<std::vector<WindowId>>();
+    qRegisterMetaType<std::vector<WindowInfoWrap>>();
+
+    //! new windows are classified away from the GUI thread, the windows
+    //! added in the same event loop pass are sent as one batch
+    m_classifier = new XWindowClassifier();
+
+    if (m_classifier->isValid()) {
+        m_classifier->moveToThread(&m_classifierThread);
+
+        connect(this, &XWindowInterface::classifyRequested, m_classifier, &XWindowClassifier::classify);
+        connect(m_classifier, &XWindowClassifier::windowsClassified, this, &XWindowInterface::windowsClassified);
+
+        m_classifierThread.start();
+    } else {
+        delete m_classifier;
+        m_classifier = nullptr;
+    }
+
+    m_classificationTimer.setSingleShot(true);
+    m_classificationTimer.setInterval(0);
+    connect(&m_classificationTimer, &QTimer::timeout, this, &XWindowInterface::sendPendingClassification);
+
+    //! window destructions and unmaps are tracked as they arrive
+    qApp->installNativeEventFilter(this);
+
     m_activities = new KActivities::Consumer(this);
     connect(KWindowSystem::self(), &KWindowSystem::activeWindowChanged
             , this, &AbstractWindowInterface::activeWindowChanged);
@@ -51,19 +79,15 @@ XWindowInterface::XWindowInterface(QObject *parent)
             (&KWindowSystem::windowChanged)
             , this, &XWindowInterface::windowChangedProxy);
 
-    auto addWindow = [&](WindowId wid) {
-        if (std::find(m_windows.cbegin(), m_windows.cend(), wid) == m_windows.cend()) {
-            if (isValidWindow(KWindowInfo(wid.value<WId>(), NET::WMWindowType))) {
-                m_windows.push_back(wid);
-                emit windowAdded(wid);
-            }
-        }
-    };
-
-    connect(KWindowSystem::self(), &KWindowSystem::windowAdded, this, addWindow);
+    connect(KWindowSystem::self(), &KWindowSystem::windowAdded, this, &XWindowInterface::classifyWindow);
     connect(KWindowSystem::self(), &KWindowSystem::windowRemoved, [this](WindowId wid) noexcept {
-        if (std::find(m_windows.cbegin(), m_windows.cend(), wid) != m_windows.end()) {
-            m_windows.remove(wid);
+        //! the window manager confirmed the removal, the id can be reused from now on
+        m_destroyedWindows.remove(wid);
+        m_classifyingWindows.remove(wid);
+        m_changedWhileClassifying.remove(wid);
+        m_unclassifiedWindows.remove(wid);
+
+        if (m_windows.remove(wid) >= 0) {
             emit windowRemoved(wid);
         }
     });
@@ -72,14 +96,23 @@ XWindowInterface::XWindowInterface(QObject *parent)
     connect(m_activities.data(), &KActivities::Consumer::currentActivityChanged
             , this, &XWindowInterface::currentActivityChanged);
 
-    // fill windows list
+    // fill windows list, all window states are classified in a single batch
+    // when the first consumer becomes interested in windows
     foreach (const auto &wid, KWindowSystem::self()->windows()) {
-        addWindow(wid);
+        classifyWindow(wid);
     }
 }
 
 XWindowInterface::~XWindowInterface()
 {
+    qApp->removeNativeEventFilter(this);
+
+    if (m_classifier) {
+        m_classifierThread.quit();
+        m_classifierThread.wait();
+
+        delete m_classifier;
+    }
 }
 
 void XWindowInterface::setViewExtraFlags(QWindow &view)
@@ -166,9 +199,9 @@ WindowId XWindowInterface::activeWindow() const
     return KWindowSystem::self()->activeWindow();
 }
 
-const std::list<WindowId> &XWindowInterface::windows() const
+const std::vector<WindowId> &XWindowInterface::windows() const
 {
-    return m_windows;
+    return m_windows.windows();
 }
 
 void XWindowInterface::setKeepAbove(const QDialog &dialog, bool above) const
@@ -284,13 +317,21 @@ WindowInfoWrap XWindowInterface::requestInfoActive() const
 
 bool XWindowInterface::isOnCurrentDesktop(WindowId wid) const
 {
-    KWindowInfo winfo(wid.value<WId>(), NET::WMDesktop);
+    if (hasWindowInfo(wid)) {
+        return inCurrentDesktop(windowInfo(wid));
+    }
+
+    KWindowInfo winfo(wid, NET::WMDesktop);
     return winfo.valid() && winfo.isOnCurrentDesktop();
 }
 
 bool XWindowInterface::isOnCurrentActivity(WindowId wid) const
 {
-    KWindowInfo winfo(wid.value<WId>(), 0, NET::WM2Activities);
+    if (hasWindowInfo(wid)) {
+        return inCurrentActivity(windowInfo(wid));
+    }
+
+    KWindowInfo winfo(wid, 0, NET::WM2Activities);
 
     return winfo.valid()
            && (winfo.activities().contains(m_activities->currentActivity()) || winfo.activities().empty());
@@ -298,33 +339,17 @@ bool XWindowInterface::isOnCurrentActivity(WindowId wid) const
 
 WindowInfoWrap XWindowInterface::requestInfo(WindowId wid) const
 {
-    const KWindowInfo winfo{wid.value<WId>(), NET::WMFrameExtents
-                            | NET::WMWindowType
-                            | NET::WMGeometry
-                            | NET::WMState};
-
-    WindowInfoWrap winfoWrap;
-
-    if (isValidWindow(winfo)) {
-        winfoWrap.setIsValid(true);
-        winfoWrap.setWid(wid);
-        winfoWrap.setIsActive(KWindowSystem::activeWindow() == wid.value<WId>());
-        winfoWrap.setIsMinimized(winfo.hasState(NET::Hidden));
-        winfoWrap.setIsMaxVert(winfo.hasState(NET::MaxVert));
-        winfoWrap.setIsMaxHoriz(winfo.hasState(NET::MaxHoriz));
-        winfoWrap.setIsFullscreen(winfo.hasState(NET::FullScreen));
-        winfoWrap.setIsShaded(winfo.hasState(NET::Shaded));
-        winfoWrap.setGeometry(winfo.frameGeometry());
-        winfoWrap.setIsKeepAbove(winfo.hasState(NET::KeepAbove));
-        winfoWrap.setHasSkipTaskbar(winfo.hasState(NET::SkipTaskbar));
-    } else if (m_desktopId == wid) {
-        winfoWrap.setIsValid(true);
-        winfoWrap.setIsPlasmaDesktop(true);
-        winfoWrap.setWid(wid);
-        winfoWrap.setHasSkipTaskbar(true);
-    }
-
-    return winfoWrap;
+    return requestInfos({wid}).front();
+}
+
+std::vector<WindowInfoWrap> XWindowInterface::requestInfos(const std::vector<WindowId> &wids) const
+{
+    return m_reader.read(wids, KWindowSystem::activeWindow());
+}
+
+std::vector<QRect> XWindowInterface::requestGeometries(const std::vector<WindowId> &wids) const
+{
+    return m_reader.readGeometries(wids);
 }
 
 bool XWindowInterface::windowCanBeDragged(WindowId wid) const
@@ -341,7 +366,7 @@ void XWindowInterface::releaseMouseEventFor(WindowId wid) const
     memset(&releaseEvent, 0, sizeof(releaseEvent));
 
     releaseEvent.response_type = XCB_BUTTON_RELEASE;
-    releaseEvent.event =  wid.toInt();
+    releaseEvent.event =  wid;
     releaseEvent.child = XCB_WINDOW_NONE;
     releaseEvent.root = QX11Info::appRootWindow();
     releaseEvent.event_x = -1;
@@ -352,7 +377,7 @@ void XWindowInterface::releaseMouseEventFor(WindowId wid) const
     releaseEvent.state = XCB_BUTTON_MASK_1;
     releaseEvent.time = XCB_CURRENT_TIME;
     releaseEvent.same_screen = true;
-    xcb_send_event( connection, false, wid.toInt(), XCB_EVENT_MASK_BUTTON_RELEASE, reinterpret_cast<const char*>(&releaseEvent));
+    xcb_send_event( connection, false, wid, XCB_EVENT_MASK_BUTTON_RELEASE, reinterpret_cast<const char*>(&releaseEvent));
 }
 
 void XWindowInterface::requestMoveWindow(WindowId wid, QPoint from) const
@@ -378,7 +403,7 @@ void XWindowInterface::requestMoveWindow(WindowId wid, QPoint from) const
     int validY = qBound(minY, from.y(), maxY);
 
     NETRootInfo ri(QX11Info::connection(), NET::WMMoveResize);
-    ri.moveResizeRequest(wInfo.wid().toUInt(), validX, validY, NET::Move);
+    ri.moveResizeRequest(wInfo.wid(), validX, validY, NET::Move);
 }
 
 void XWindowInterface::requestToggleMaximized(WindowId wid) const
@@ -386,7 +411,7 @@ void XWindowInterface::requestToggleMaximized(WindowId wid) const
     WindowInfoWrap wInfo = requestInfo(wid);
     bool restore = wInfo.isMaxHoriz() && wInfo.isMaxVert();
 
-    NETWinInfo ni(QX11Info::connection(), wid.toInt(), QX11Info::appRootWindow(), NET::WMState, NET::Properties2());
+    NETWinInfo ni(QX11Info::connection(), wid, QX11Info::appRootWindow(), NET::WMState, NET::Properties2());
 
     if (restore) {
         ni.setState(NET::States(), NET::Max);
@@ -395,69 +420,264 @@ void XWindowInterface::requestToggleMaximized(WindowId wid) const
     }
 }
 
-bool XWindowInterface::isValidWindow(const KWindowInfo &winfo) const
+void XWindowInterface::classifyWindow(WindowId wid)
 {
-    constexpr auto types = NET::DockMask | NET::MenuMask | NET::SplashMask | NET::NormalMask;
-    auto winType = winfo.windowType(types);
+    if (m_windows.contains(wid) || m_classifyingWindows.contains(wid)) {
+        return;
+    }
+
+    //! a new window that reuses the id of a destroyed one
+    m_destroyedWindows.remove(wid);
 
-    if (winType == -1) {
-        // Trying to get more types for verify if the window have any other type
-        winType = winfo.windowType(~types & NET::AllTypesMask);
+    //! nobody is interested in windows yet, no X requests are needed
+    if (!hasInterest()) {
+        m_unclassifiedWindows.insert(wid);
+        return;
+    }
 
-        if (winType == -1) {
-            qWarning() << KWindowInfo(winfo.win(), 0, NET::WM2WindowClass).windowClassName()
-                       << "doesn't have any WindowType, assuming as NET::Normal";
-            return true;
+    m_classifyingWindows.insert(wid);
+    m_pendingClassification.push_back(wid);
+
+    if (!m_classificationTimer.isActive()) {
+        m_classificationTimer.start();
+    }
+}
+
+void XWindowInterface::interestGained()
+{
+    AbstractWindowInterface::interestGained();
+
+    const std::vector<WindowId> wids = m_unclassifiedWindows.windows();
+    m_unclassifiedWindows.clear();
+
+    for (const auto &wid : wids) {
+        classifyWindow(wid);
+    }
+}
+
+void XWindowInterface::sendPendingClassification()
+{
+    std::vector<WindowId> wids;
+    wids.swap(m_pendingClassification);
+
+    if (wids.empty()) {
+        return;
+    }
+
+    if (m_classifier) {
+        emit classifyRequested(wids, KWindowSystem::activeWindow());
+    } else {
+        windowsClassified(wids, m_reader.read(wids, KWindowSystem::activeWindow()));
+    }
+}
+
+void XWindowInterface::windowsClassified(const std::vector<WindowId> &wids, const std::vector<WindowInfoWrap> &infos)
+{
+    //! windows removed or destroyed while they were classified are ignored
+    std::vector<WindowId> classifiedWids;
+    std::vector<WindowInfoWrap> classifiedInfos;
+    std::vector<WindowId> changedWids;
+
+    const WindowId activeWid = KWindowSystem::activeWindow();
+
+    for (size_t i = 0; i < wids.size(); ++i) {
+        if (m_classifyingWindows.remove(wids[i]) < 0) {
+            continue;
+        }
+
+        if (m_changedWhileClassifying.remove(wids[i]) >= 0) {
+            changedWids.push_back(wids[i]);
+        }
+
+        classifiedWids.push_back(wids[i]);
+        classifiedInfos.push_back(infos[i]);
+
+        //! the active window may have changed since the batch was sent
+        if (classifiedInfos.back().isValid() && !classifiedInfos.back().isPlasmaDesktop()) {
+            classifiedInfos.back().setIsActive(activeWid == wids[i]);
+        }
+    }
+
+    storeWindowsInfo(classifiedWids, classifiedInfos);
+
+    std::vector<WindowId> addedWids;
+
+    for (const auto &wid : classifiedWids) {
+        //! only valid windows are stored in the window states cache
+        if (hasWindowInfo(wid)) {
+            m_windows.insert(wid);
+            addedWids.push_back(wid);
         }
     }
 
-    return !((winType & NET::Menu) || (winType & NET::Dock) || (winType & NET::Splash));
+    watchWindows(addedWids);
+
+    for (const auto &wid : addedWids) {
+        emit windowAdded(wid);
+    }
+
+    for (const auto &wid : changedWids) {
+        if (m_windows.contains(wid)) {
+            queueWindowChanged(wid, AllProperties);
+        }
+    }
+}
+
+void XWindowInterface::watchWindows(const std::vector<WindowId> &wids) const
+{
+    xcb_connection_t *c = QX11Info::connection();
+
+    std::vector<xcb_get_window_attributes_cookie_t> cookies;
+    cookies.reserve(wids.size());
+
+    for (const auto &wid : wids) {
+        cookies.push_back(xcb_get_window_attributes(c, static_cast<xcb_window_t>(wid)));
+    }
+
+    //! the event mask is shared with KWindowSystem for the same connection,
+    //! so structure notifications are added to the already selected events
+    for (size_t i = 0; i < wids.size(); ++i) {
+        QScopedPointer<xcb_get_window_attributes_reply_t, QScopedPointerPodDeleter>
+        attributes(xcb_get_window_attributes_reply(c, cookies[i], nullptr));
+
+        if (!attributes) {
+            continue;
+        }
+
+        const uint32_t eventMask = attributes->your_event_mask | XCB_EVENT_MASK_STRUCTURE_NOTIFY;
+        xcb_change_window_attributes(c, static_cast<xcb_window_t>(wids[i]), XCB_CW_EVENT_MASK, &eventMask);
+    }
+
+    xcb_flush(c);
+}
+
+bool XWindowInterface::nativeEventFilter(const QByteArray &eventType, void *message, long *result)
+{
+    Q_UNUSED(result);
+
+    if (eventType != "xcb_generic_event_t") {
+        return false;
+    }
+
+    xcb_generic_event_t *event = static_cast<xcb_generic_event_t *>(message);
+
+    switch (event->response_type & ~0x80) {
+        case XCB_DESTROY_NOTIFY: {
+            auto destroyEvent = reinterpret_cast<xcb_destroy_notify_event_t *>(event);
+            windowDestroyed(destroyEvent->window);
+            break;
+        }
+
+        case XCB_UNMAP_NOTIFY: {
+            //! minimized windows are unmapped too, so the window is only checked again,
+            //! windows that became invalid are reaped when their state is stored
+            auto unmapEvent = reinterpret_cast<xcb_unmap_notify_event_t *>(event);
+
+            if (m_classifyingWindows.contains(unmapEvent->window)) {
+                m_changedWhileClassifying.insert(unmapEvent->window);
+            } else if (m_windows.contains(unmapEvent->window)) {
+                queueWindowChanged(unmapEvent->window, AllProperties);
+            }
+
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+void XWindowInterface::windowDestroyed(WindowId wid)
+{
+    //! some windows e.g. notifications are never removed from the window manager
+    //! client list, the destroyed window is removed immediately and its id stays
+    //! as a tombstone until the window manager reports it removed or reuses it
+    if (m_classifyingWindows.remove(wid) >= 0) {
+        m_changedWhileClassifying.remove(wid);
+        m_destroyedWindows.insert(wid);
+        return;
+    }
+
+    if (m_windows.remove(wid) < 0) {
+        return;
+    }
+
+    m_destroyedWindows.insert(wid);
+
+    emit windowRemoved(wid);
 }
 
 void XWindowInterface::windowChangedProxy(WId wid, NET::Properties prop1, NET::Properties2 prop2)
 {
     //! if the view changed is ignored
-    if (std::find(m_views.cbegin(), m_views.cend(), wid) != m_views.cend())
+    if (m_views.contains(wid))
+        return;
+
+    //! late events of destroyed windows are ignored
+    if (m_destroyedWindows.contains(wid))
         return;
 
-    const auto winType = KWindowInfo(wid, NET::WMWindowType).windowType(NET::DesktopMask);
+    //! windows that are not classified yet are requested completely later,
+    //! so their events are ignored before any X request
+    if (!hasInterest() || m_unclassifiedWindows.contains(wid)) {
+        return;
+    }
+
+    //! windows still classified are requested again when they are added
+    if (m_classifyingWindows.contains(wid)) {
+        m_changedWhileClassifying.insert(wid);
+        return;
+    }
 
-    //! update desktop id
-    if (winType != -1 && (winType & NET::Desktop)) {
-        m_desktopId = wid;
-        emit windowChanged(wid);
+    //! the desktop window is known from its classification
+    if (hasWindowInfo(wid) && windowInfo(wid).isPlasmaDesktop()) {
+        queueWindowChanged(wid, AllProperties);
         return;
     }
 
-    //! accept only NET::Properties events,
+    //! accept only NET::Properties events and activities changes,
     //! ignore when the user presses a key, or a window is sending X events etc.
     //! without needing to (e.g. Firefox, https://bugzilla.mozilla.org/show_bug.cgi?id=1389953)
     //! NET::WM2UserTime, NET::WM2IconPixmap etc....
-    if (prop1 == 0) {
+    if (prop1 == 0 && !(prop2 & NET::WM2Activities)) {
         return;
     }
 
     //! accept only the following NET:Properties changed signals
-    //! NET::WMState, NET::WMGeometry, NET::ActiveWindow
-    if (!((prop1 & NET::WMState) || (prop1 & NET::WMGeometry) || (prop1 & NET::ActiveWindow))) {
+    //! NET::WMState, NET::WMGeometry, NET::ActiveWindow, NET::WMDesktop, NET::WM2Activities
+    //! desktop and activities are needed in order to keep the window states cache valid
+    if (!((prop1 & NET::WMState) || (prop1 & NET::WMGeometry) || (prop1 & NET::ActiveWindow)
+          || (prop1 & NET::WMDesktop) || (prop2 & NET::WM2Activities))) {
         return;
     }
 
-    //! when only WMState changed we can whitelist the acceptable states
-    if ((prop1 & NET::WMState) && !(prop1 & NET::WMGeometry) && !(prop1 & NET::ActiveWindow)) {
-        KWindowInfo info(wid, NET::WMState);
+    //! state changes are not checked here, the batched read of the flush
+    //! drops the ones that did not change any of the tracked states
+    ChangedProperties properties{NoProperty};
 
-        if (info.valid()) {
-            if (!info.hasState(NET::Sticky) && !info.hasState(NET::Shaded)
-                && !info.hasState(NET::FullScreen) && !info.hasState(NET::Hidden)) {
-                return;
-            }
-        } else {
-            return;
-        }
+    if (prop1 & NET::WMGeometry) {
+        properties |= GeometryProperty;
+    }
+
+    if (prop1 & NET::WMState) {
+        properties |= StateProperty;
+    }
+
+    if (prop1 & NET::ActiveWindow) {
+        properties |= ActiveProperty;
+    }
+
+    if (prop1 & NET::WMDesktop) {
+        properties |= DesktopProperty;
+    }
+
+    if (prop2 & NET::WM2Activities) {
+        properties |= ActivitiesProperty;
     }
 
-    emit windowChanged(wid);
+    queueWindowChanged(wid, properties);
 }
 
 }
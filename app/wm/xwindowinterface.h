@@ -24,17 +24,27 @@
 // local
 #include "abstractwindowinterface.h"
 #include "windowinfowrap.h"
+#include "xwindowclassifier.h"
+
+// C++
+#include <vector>
 
 // Qt
+#include <QAbstractNativeEventFilter>
 #include <QObject>
+#include <QThread>
+#include <QTimer>
 
 // KDE
 #include <KWindowInfo>
 #include <KWindowEffects>
 
+// X11
+#include <xcb/xcb.h>
+
 namespace Latte {
 
-class XWindowInterface : public AbstractWindowInterface
+class XWindowInterface : public AbstractWindowInterface, public QAbstractNativeEventFilter
 {
     Q_OBJECT
 
@@ -51,10 +61,12 @@ public:
 
     WindowId activeWindow() const override;
     WindowInfoWrap requestInfo(WindowId wid) const override;
+    std::vector<WindowInfoWrap> requestInfos(const std::vector<WindowId> &wids) const override;
+    std::vector<QRect> requestGeometries(const std::vector<WindowId> &wids) const override;
     WindowInfoWrap requestInfoActive() const override;
     bool isOnCurrentDesktop(WindowId wid) const override;
     bool isOnCurrentActivity(WindowId wid) const override;
-    const std::list<WindowId> &windows() const override;
+    const std::vector<WindowId> &windows() const override;
 
     void setKeepAbove(const QDialog &dialog, bool above = true) const override;
     void skipTaskBar(const QDialog &dialog) const override;
@@ -68,11 +80,41 @@ public:
 
     void setEdgeStateFor(QWindow *view, bool active) const override;
 
+    bool nativeEventFilter(const QByteArray &eventType, void *message, long *result) override;
+
+protected:
+    void interestGained() override;
+
+signals:
+    void classifyRequested(const std::vector<Latte::WindowId> &wids, Latte::WindowId activeWindow);
+
+private slots:
+    void windowsClassified(const std::vector<Latte::WindowId> &wids, const std::vector<Latte::WindowInfoWrap> &infos);
+
 private:
-    bool isValidWindow(const KWindowInfo &winfo) const;
+    void classifyWindow(WindowId wid);
+    void sendPendingClassification();
+    void watchWindows(const std::vector<WindowId> &wids) const;
+    void windowDestroyed(WindowId wid);
     void windowChangedProxy(WId wid, NET::Properties prop1, NET::Properties2 prop2);
 
-    WindowId m_desktopId;
+    //! destroyed windows that the window manager has not removed yet
+    WindowsRegistry m_destroyedWindows;
+
+    //! new windows are classified in a worker thread and are added in batches,
+    //! changes that arrive meanwhile are requested again when they are added
+    WindowsRegistry m_classifyingWindows;
+    WindowsRegistry m_changedWhileClassifying;
+    std::vector<WindowId> m_pendingClassification;
+    QTimer m_classificationTimer;
+
+    //! windows that are classified only when a consumer becomes interested in windows
+    WindowsRegistry m_unclassifiedWindows;
+
+    QThread m_classifierThread;
+    XWindowClassifier *m_classifier{nullptr};
+
+    XWindowInfoReader m_reader;
 };
 
 }
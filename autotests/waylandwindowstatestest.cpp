@@ -0,0 +1,191 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// local
+#include "wm/waylandwindowstates.h"
+
+// Qt
+#include <QObject>
+#include <QRect>
+#include <QString>
+#include <QtTest>
+
+namespace {
+
+//! the plasma window getters that are used by the window states store
+class FakePlasmaWindow
+{
+public:
+    quint32 internalId() const { return id; }
+    bool isValid() const { return valid; }
+    bool skipTaskbar() const { return skipTaskbarFlag; }
+    QString appId() const { return app; }
+    QRect geometry() const { return rect; }
+    bool isMinimized() const { return minimized; }
+    bool isMaximized() const { return maximized; }
+    bool isFullscreen() const { return fullscreen; }
+    bool isShaded() const { return shaded; }
+    bool isKeepAbove() const { return keepAbove; }
+    bool isActive() const { return active; }
+    bool isOnAllDesktops() const { return onAllDesktops; }
+    quint32 virtualDesktop() const { return desktop; }
+
+public:
+    quint32 id{1};
+    bool valid{true};
+    bool skipTaskbarFlag{false};
+    QString app{QStringLiteral("org.kde.konsole")};
+    QRect rect{0, 0, 800, 600};
+    bool minimized{false};
+    bool maximized{false};
+    bool fullscreen{false};
+    bool shaded{false};
+    bool keepAbove{false};
+    bool active{false};
+    bool onAllDesktops{false};
+    quint32 desktop{1};
+};
+
+using WindowStates = Latte::WaylandWindowStates<FakePlasmaWindow>;
+using Latte::AbstractWindowInterface;
+
+}
+
+class WaylandWindowStatesTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void newWindowIsFilledCompletely();
+    void onlyChangedPropertiesAreUpdated();
+    void skipTaskbarWindowsAreNotTracked();
+    void skipTaskbarChangesTrackTheWindow();
+    void plasmaDesktopIsNotTracked();
+    void removedWindowHasNoState();
+};
+
+void WaylandWindowStatesTest::newWindowIsFilledCompletely()
+{
+    WindowStates states;
+    FakePlasmaWindow w;
+    w.maximized = true;
+    w.active = true;
+    w.desktop = 2;
+
+    //! even when only one property is reported, a new window is read entirely
+    QCOMPARE(states.update(&w, AbstractWindowInterface::GeometryProperty), WindowStates::Added);
+
+    const Latte::WindowInfoWrap &winfo = states.state(w.id);
+    QVERIFY(winfo.isValid());
+    QCOMPARE(winfo.wid(), w.id);
+    QCOMPARE(winfo.geometry(), w.rect);
+    QVERIFY(winfo.isMaxVert() && winfo.isMaxHoriz());
+    QVERIFY(winfo.isActive());
+    QCOMPARE(winfo.desktop(), 2);
+    //! the app id is the window class, the color schemes are shared through it
+    QCOMPARE(winfo.windowClass(), w.app);
+}
+
+void WaylandWindowStatesTest::onlyChangedPropertiesAreUpdated()
+{
+    WindowStates states;
+    FakePlasmaWindow w;
+    states.update(&w, AbstractWindowInterface::AllProperties);
+
+    w.rect = QRect(100, 100, 400, 300);
+    w.minimized = true;
+    w.active = true;
+
+    QCOMPARE(states.update(&w, AbstractWindowInterface::GeometryProperty), WindowStates::Changed);
+    QCOMPARE(states.state(w.id).geometry(), w.rect);
+    QVERIFY(!states.state(w.id).isMinimized());
+    QVERIFY(!states.state(w.id).isActive());
+
+    QCOMPARE(states.update(&w, AbstractWindowInterface::StateProperty), WindowStates::Changed);
+    QVERIFY(states.state(w.id).isMinimized());
+    QVERIFY(!states.state(w.id).isActive());
+
+    QCOMPARE(states.update(&w, AbstractWindowInterface::ActiveProperty), WindowStates::Changed);
+    QVERIFY(states.state(w.id).isActive());
+}
+
+void WaylandWindowStatesTest::skipTaskbarWindowsAreNotTracked()
+{
+    WindowStates states;
+    FakePlasmaWindow w;
+    w.skipTaskbarFlag = true;
+
+    QCOMPARE(states.update(&w, AbstractWindowInterface::AllProperties), WindowStates::NotTracked);
+    QVERIFY(!states.state(w.id).isValid());
+
+    QCOMPARE(states.update(&w, AbstractWindowInterface::GeometryProperty), WindowStates::NotTracked);
+    QVERIFY(!states.state(w.id).isValid());
+}
+
+void WaylandWindowStatesTest::skipTaskbarChangesTrackTheWindow()
+{
+    WindowStates states;
+    FakePlasmaWindow w;
+    states.update(&w, AbstractWindowInterface::AllProperties);
+
+    w.skipTaskbarFlag = true;
+    QCOMPARE(states.update(&w, AbstractWindowInterface::StateProperty), WindowStates::Removed);
+    QVERIFY(!states.state(w.id).isValid());
+
+    //! the geometry changed while the window was not tracked
+    w.rect = QRect(10, 20, 300, 200);
+    w.skipTaskbarFlag = false;
+    QCOMPARE(states.update(&w, AbstractWindowInterface::StateProperty), WindowStates::Added);
+    QCOMPARE(states.state(w.id).geometry(), w.rect);
+}
+
+void WaylandWindowStatesTest::plasmaDesktopIsNotTracked()
+{
+    WindowStates states;
+    FakePlasmaWindow w;
+    w.app = QStringLiteral("org.kde.plasmashell");
+    w.skipTaskbarFlag = true;
+
+    QCOMPARE(states.update(&w, AbstractWindowInterface::AllProperties), WindowStates::NotTracked);
+
+    //! it is still known, it is needed when it becomes the active window
+    QVERIFY(states.state(w.id).isValid());
+    QVERIFY(states.state(w.id).isPlasmaDesktop());
+
+    QCOMPARE(states.update(&w, AbstractWindowInterface::ActiveProperty), WindowStates::NotTracked);
+}
+
+void WaylandWindowStatesTest::removedWindowHasNoState()
+{
+    WindowStates states;
+    FakePlasmaWindow w;
+    states.update(&w, AbstractWindowInterface::AllProperties);
+    QVERIFY(states.contains(w.id));
+
+    states.remove(w.id);
+    QVERIFY(!states.contains(w.id));
+    QVERIFY(!states.state(w.id).isValid());
+
+    //! a window that is mapped again is a new window
+    QCOMPARE(states.update(&w, AbstractWindowInterface::GeometryProperty), WindowStates::Added);
+}
+
+QTEST_GUILESS_MAIN(WaylandWindowStatesTest)
+
+#include "waylandwindowstatestest.moc"
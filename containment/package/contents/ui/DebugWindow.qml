@@ -33,6 +33,41 @@ Window{
 
     property string space:" :   "
 
+    //! visibility profiling labels and values, they are refreshed periodically
+    property var profilingRows: []
+
+    function updateProfilingRows() {
+        if (!latteView || !latteView.visibility) {
+            profilingRows = [];
+            return;
+        }
+
+        var data = latteView.visibility.profilingData();
+        var rows = ["Profiling Period"+space, data.seconds + " sec."];
+
+        for (var counter in data.counters) {
+            rows.push(counter + space);
+            rows.push(data.counters[counter]);
+        }
+
+        for (var handler in data.handlers) {
+            var stats = data.handlers[handler];
+            rows.push(handler + space);
+            rows.push(stats.calls + " calls, avg " + stats.averageUsecs + " us, max " + stats.maxUsecs + " us, ["
+                      + stats.histogram.join(" ") + "]");
+        }
+
+        profilingRows = rows;
+    }
+
+    Timer{
+        interval: 1000
+        repeat: true
+        running: true
+        triggeredOnStart: true
+        onTriggered: updateProfilingRows();
+    }
+
     PlasmaExtras.ScrollArea {
         id: scrollArea
 
@@ -750,6 +785,22 @@ Window{
                 text: layoutsContainer.endLayout.sizeWithNoFillApplets+" px."
             }
 
+            Text{
+                text: "   -----------   "
+            }
+
+            Text{
+                text: " -----------   "
+            }
+
+            Repeater{
+                model: profilingRows
+
+                Text{
+                    text: modelData
+                }
+            }
+
         }
 
     }
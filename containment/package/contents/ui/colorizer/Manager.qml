@@ -52,13 +52,15 @@ Loader{
                                && !root.editMode && Latte.WindowSystem.compositingActive
 
     readonly property real currentBackgroundBrightness: item ? item.currentBrightness : -1000
+    //! while the wallpaper is analyzed the plasma theme is used as neutral state
+    readonly property bool backgroundIsReady: item ? item.isReady : true
 
     property QtObject applyTheme: {
         if (forceSolidnessAndColorize && latteView.visibility.touchingWindowScheme) {
             return latteView.visibility.touchingWindowScheme;
         }
 
-        if (themeExtended) {
+        if (themeExtended && backgroundIsReady) {
             if (currentBackgroundBrightness > 127.5) {
                 return themeExtended.lightTheme;
             } else {
@@ -106,5 +108,22 @@ Loader{
         activity: managedLayout ? managedLayout.lastUsedActivity : ""
         location: plasmoid.location
         screenName: latteView && latteView.positioner ? latteView.positioner.currentScreenName : ""
+        span: {
+            if (!latteView || latteView.screenGeometry.width <= 0 || latteView.screenGeometry.height <= 0
+                    || latteView.absoluteGeometry.width <= 0 || latteView.absoluteGeometry.height <= 0) {
+                return Qt.point(0, 1);
+            }
+
+            var screenGeometry = latteView.screenGeometry;
+            var viewGeometry = latteView.absoluteGeometry;
+
+            if (root.isVertical) {
+                return Qt.point((viewGeometry.y - screenGeometry.y) / screenGeometry.height,
+                                (viewGeometry.y + viewGeometry.height - screenGeometry.y) / screenGeometry.height);
+            }
+
+            return Qt.point((viewGeometry.x - screenGeometry.x) / screenGeometry.width,
+                            (viewGeometry.x + viewGeometry.width - screenGeometry.x) / screenGeometry.width);
+        }
     }
 }
@@ -32,8 +32,10 @@ BackgroundTracker::BackgroundTracker(QObject *parent)
     connect(this, &BackgroundTracker::activityChanged, this, &BackgroundTracker::update);
     connect(this, &BackgroundTracker::locationChanged, this, &BackgroundTracker::update);
     connect(this, &BackgroundTracker::screenNameChanged, this, &BackgroundTracker::update);
+    connect(this, &BackgroundTracker::spanChanged, this, &BackgroundTracker::update);
 
     connect(m_cache, &PlasmaExtended::BackgroundCache::backgroundChanged, this, &BackgroundTracker::backgroundChanged);
+    connect(m_cache, &PlasmaExtended::BackgroundCache::hintsChanged, this, &BackgroundTracker::hintsChanged);
 }
 
 BackgroundTracker::~BackgroundTracker()
@@ -45,6 +47,11 @@ bool BackgroundTracker::isBusy() const
     return m_busy;
 }
 
+bool BackgroundTracker::isReady() const
+{
+    return m_ready;
+}
+
 int BackgroundTracker::location() const
 {
     return m_location;
@@ -63,6 +70,22 @@ void BackgroundTracker::setLocation(int location)
     emit locationChanged();
 }
 
+QPointF BackgroundTracker::span() const
+{
+    return m_span;
+}
+
+void BackgroundTracker::setSpan(QPointF span)
+{
+    if (m_span == span) {
+        return;
+    }
+
+    m_span = span;
+
+    emit spanChanged();
+}
+
 float BackgroundTracker::currentBrightness() const
 {
     return m_brightness;
@@ -107,17 +130,41 @@ void BackgroundTracker::backgroundChanged(const QString &activity, const QString
     }
 }
 
+void BackgroundTracker::hintsChanged(const QString &imageFile)
+{
+    if (!m_activity.isEmpty() && !m_screenName.isEmpty()
+            && m_cache->background(m_activity, m_screenName) == imageFile) {
+        update();
+    }
+}
+
 void BackgroundTracker::update()
 {
     if (m_activity.isEmpty() || m_screenName.isEmpty()) {
         return;
     }
 
-    m_brightness = m_cache->brightnessFor(m_activity, m_screenName, m_location);
-    m_busy = m_cache->busyFor(m_activity, m_screenName, m_location);
+    bool ready = m_cache->hintsReady(m_activity, m_screenName, m_location);
 
-    emit currentBrightnessChanged();
-    emit isBusyChanged();
+    //! the span follows the view geometry, the hints are answered
+    //! from the cached edge sums without analyzing the image again
+    float brightness = m_cache->brightnessFor(m_activity, m_screenName, m_location, m_span.x(), m_span.y());
+    bool busy = m_cache->busyFor(m_activity, m_screenName, m_location, m_span.x(), m_span.y());
+
+    if (m_brightness != brightness) {
+        m_brightness = brightness;
+        emit currentBrightnessChanged();
+    }
+
+    if (m_busy != busy) {
+        m_busy = busy;
+        emit isBusyChanged();
+    }
+
+    if (m_ready != ready) {
+        m_ready = ready;
+        emit isReadyChanged();
+    }
 }
 
 }
@@ -26,6 +26,7 @@
 
 // Qt
 #include <QObject>
+#include <QPointF>
 
 namespace Latte{
 
@@ -34,8 +35,13 @@ class BackgroundTracker: public QObject
     Q_OBJECT
 
     Q_PROPERTY(bool isBusy READ isBusy NOTIFY isBusyChanged)
+    //! the background is still analyzed, busy and brightness are neutral until then
+    Q_PROPERTY(bool isReady READ isReady NOTIFY isReadyChanged)
 
     Q_PROPERTY(int location READ location WRITE setLocation NOTIFY locationChanged)
+    //! the part of the edge that the view occupies, x is its start and y its end
+    //! as fractions of the screen edge length, (0,1) is the entire edge
+    Q_PROPERTY(QPointF span READ span WRITE setSpan NOTIFY spanChanged)
 
     Q_PROPERTY(float currentBrightness READ currentBrightness NOTIFY currentBrightnessChanged)
 
@@ -47,10 +53,14 @@ public:
     virtual ~BackgroundTracker();
 
     bool isBusy() const;
+    bool isReady() const;
 
     int location() const;
     void setLocation(int location);
 
+    QPointF span() const;
+    void setSpan(QPointF span);
+
     float currentBrightness() const;
 
     QString activity() const;
@@ -63,20 +73,25 @@ signals:
     void activityChanged();
     void currentBrightnessChanged();
     void isBusyChanged();
+    void isReadyChanged();
     void locationChanged();
     void screenNameChanged();
+    void spanChanged();
 
 private slots:
     void backgroundChanged(const QString &activity, const QString &screenName);
+    void hintsChanged(const QString &imageFile);
     void update();
 
 private:
     // local
     bool m_busy{false};
+    bool m_ready{false};
     float m_brightness{-1000};
     PlasmaExtended::BackgroundCache *m_cache{nullptr};
 
     // Qt
+    QPointF m_span{0, 1};
     QString m_activity;
     QString m_screenName;
 
@@ -23,8 +23,32 @@
 // Qt
 #include <QtMath>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace Latte {
 
+namespace {
+#ifdef __SSE2__
+//! brightness of four pixels, r*299 + g*587 + b*114 for each one of them
+inline __m128i brightnessOf4Pixels(__m128i pixels)
+{
+    const __m128i mask = _mm_set1_epi32(0x00ff00ff);
+
+    //! 16bit lanes, blue and red of each pixel
+    const __m128i blueRed = _mm_and_si128(pixels, mask);
+    //! 16bit lanes, green and alpha of each pixel
+    const __m128i greenAlpha = _mm_and_si128(_mm_srli_epi32(pixels, 8), mask);
+
+    const __m128i blueRedWeights = _mm_set1_epi32((299 << 16) | 114);
+    const __m128i greenWeights = _mm_set1_epi32(587);
+
+    return _mm_add_epi32(_mm_madd_epi16(blueRed, blueRedWeights), _mm_madd_epi16(greenAlpha, greenWeights));
+}
+#endif
+}
+
 float colorBrightness(QColor color)
 {
     return colorBrightness(color.red(), color.green(), color.blue());
@@ -71,4 +95,56 @@ float colorLumina(float r, float g, float b)
     return luminosity;
 }
 
+quint32 pixelBrightness(QRgb rgb)
+{
+    return static_cast<quint32>(qRed(rgb) * 299 + qGreen(rgb) * 587 + qBlue(rgb) * 114);
+}
+
+quint64 pixelsBrightnessSum(const QRgb *pixels, int count)
+{
+    quint64 sum{0};
+    int i{0};
+
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+
+    for (; i + 4 <= count; i += 4) {
+        const __m128i brightness = brightnessOf4Pixels(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i)));
+
+        //! 64bit sums, rows of huge images can not overflow them
+        sums = _mm_add_epi64(sums, _mm_unpacklo_epi32(brightness, zero));
+        sums = _mm_add_epi64(sums, _mm_unpackhi_epi32(brightness, zero));
+    }
+
+    quint64 lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), sums);
+    sum = lanes[0] + lanes[1];
+#endif
+
+    for (; i < count; ++i) {
+        sum += pixelBrightness(pixels[i]);
+    }
+
+    return sum;
+}
+
+void addPixelsBrightness(const QRgb *pixels, int count, quint32 *sums)
+{
+    int i{0};
+
+#ifdef __SSE2__
+    for (; i + 4 <= count; i += 4) {
+        __m128i *target = reinterpret_cast<__m128i *>(sums + i);
+        const __m128i brightness = brightnessOf4Pixels(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + i)));
+
+        _mm_storeu_si128(target, _mm_add_epi32(_mm_loadu_si128(target), brightness));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        sums[i] += pixelBrightness(pixels[i]);
+    }
+}
+
 }
@@ -31,4 +31,13 @@ float colorLumina(QColor color);
 float colorLumina(QRgb rgb);
 float colorLumina(float r, float g, float b);
 
+//! integer brightness kernels, the brightness of each pixel is multiplied by 1000.
+//! x86 cpus are using SSE2 and the rest a scalar implementation
+quint32 pixelBrightness(QRgb rgb);
+//! the brightness sum of a row of pixels
+quint64 pixelsBrightnessSum(const QRgb *pixels, int count);
+//! adds the brightness of each pixel to the sums at the same position,
+//! a sum can hold more than 16000 pixels before it overflows
+void addPixelsBrightness(const QRgb *pixels, int count, quint32 *sums);
+
 }
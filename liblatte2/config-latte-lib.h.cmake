@@ -2,5 +2,6 @@
 #define CONFIG_LATTE_LIB_H
 
 #cmakedefine01 ENABLE_MAKE_UNIQUE
+#cmakedefine01 HAVE_JPEG
 
 #endif // CONFIG_LATTE_LIB_H
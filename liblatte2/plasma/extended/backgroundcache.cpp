@@ -21,11 +21,31 @@
 
 // local
 #include "commontools.h"
+#include "config-latte-lib.h"
+
+// C++
+#include <functional>
+#include <vector>
+
+#if HAVE_JPEG
+    #include <csetjmp>
+    #include <cstdio>
+#endif
 
 // Qt
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QImage>
+#include <QImageReader>
+#include <QRect>
 #include <QRgb>
+#include <QRunnable>
 #include <QtMath>
 
 // Plasma
@@ -35,17 +55,177 @@
 #include <KConfigGroup>
 #include <KDirWatch>
 
+#if HAVE_JPEG
+    // JPEG
+    #include <jpeglib.h>
+#endif
+
 #define PLASMACONFIG "plasma-org.kde.plasma.desktop-appletsrc"
 #define DEFAULTWALLPAPER "/usr/share/wallpapers/Next/contents/images/1920x1080.png"
+#define HINTSFILEMAGIC 0x4c424843 //! "LBHC"
+#define HINTSFILEVERSION 2
+//! the edges are split in that many sections for the span measurements
+#define SPANSECTIONS 512
+//! the edge strips thickness, 24px. should be enough because the views are always snapped to edges
+#define STRIPTHICKNESS 24
 
 namespace Latte{
 namespace PlasmaExtended {
 
+namespace {
+//! runs a function of the cache in an analysis thread
+class AnalysisJob : public QRunnable
+{
+public:
+    explicit AnalysisJob(std::function<void()> job)
+        : m_job(std::move(job)) {
+    }
+
+    void run() override {
+        m_job();
+    }
+
+private:
+    std::function<void()> m_job;
+};
+
+#if HAVE_JPEG
+struct JpegErrorManager {
+    jpeg_error_mgr manager;
+    jmp_buf jump;
+};
+
+void jpegErrorExit(j_common_ptr info)
+{
+    longjmp(reinterpret_cast<JpegErrorManager *>(info->err)->jump, 1);
+}
+
+void jpegOutputMessage(j_common_ptr)
+{
+    //! broken images fall back to the generic readers, the libjpeg warnings are not needed
+}
+
+//! decodes the image row by row and keeps only the edge strips, that way the decoded
+//! image is never stored entirely in memory and it is decoded only once for all edges.
+//! Nothing that needs destruction is created in this function after setjmp.
+bool jpegEdgeStrips(const QString &imageFile, QHash<Plasma::Types::Location, QImage> &strips)
+{
+    FILE *file = fopen(QFile::encodeName(imageFile).constData(), "rb");
+
+    if (!file) {
+        return false;
+    }
+
+    jpeg_decompress_struct info;
+    JpegErrorManager error;
+
+    info.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = jpegErrorExit;
+    error.manager.output_message = jpegOutputMessage;
+
+    if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&info);
+        fclose(file);
+        strips.clear();
+        return false;
+    }
+
+    jpeg_create_decompress(&info);
+    jpeg_stdio_src(&info, file);
+    jpeg_read_header(&info, TRUE);
+
+    //! cmyk images can not be converted to rgb by libjpeg
+    if (info.jpeg_color_space == JCS_CMYK || info.jpeg_color_space == JCS_YCCK) {
+        jpeg_destroy_decompress(&info);
+        fclose(file);
+        return false;
+    }
+
+    info.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&info);
+
+    const int width = static_cast<int>(info.output_width);
+    const int height = static_cast<int>(info.output_height);
+    const int maskHeight = qMin(STRIPTHICKNESS, height);
+    const int maskWidth = qMin(STRIPTHICKNESS, width);
+
+    strips[Plasma::Types::TopEdge] = QImage(width, maskHeight, QImage::Format_ARGB32);
+    strips[Plasma::Types::BottomEdge] = QImage(width, maskHeight, QImage::Format_ARGB32);
+    strips[Plasma::Types::LeftEdge] = QImage(maskWidth, height, QImage::Format_ARGB32);
+    strips[Plasma::Types::RightEdge] = QImage(maskWidth, height, QImage::Format_ARGB32);
+
+    QRgb *top = reinterpret_cast<QRgb *>(strips[Plasma::Types::TopEdge].bits());
+    QRgb *bottom = reinterpret_cast<QRgb *>(strips[Plasma::Types::BottomEdge].bits());
+    QRgb *left = reinterpret_cast<QRgb *>(strips[Plasma::Types::LeftEdge].bits());
+    QRgb *right = reinterpret_cast<QRgb *>(strips[Plasma::Types::RightEdge].bits());
+
+    //! the decoded row, it is released by libjpeg
+    JSAMPARRAY row = (*info.mem->alloc_sarray)(reinterpret_cast<j_common_ptr>(&info), JPOOL_IMAGE,
+                                                info.output_width * info.output_components, 1);
+
+    while (info.output_scanline < info.output_height) {
+        const int y = static_cast<int>(info.output_scanline);
+        jpeg_read_scanlines(&info, row, 1);
+
+        const JSAMPLE *pixels = row[0];
+        QRgb *rowTop = y < maskHeight ? top + y * width : nullptr;
+        QRgb *rowBottom = y >= height - maskHeight ? bottom + (y - height + maskHeight) * width : nullptr;
+
+        for (int x = 0; x < width; ++x, pixels += 3) {
+            const QRgb pixel = qRgb(pixels[0], pixels[1], pixels[2]);
+
+            if (rowTop) {
+                rowTop[x] = pixel;
+            }
+
+            if (rowBottom) {
+                rowBottom[x] = pixel;
+            }
+
+            if (x < maskWidth) {
+                left[y * maskWidth + x] = pixel;
+            }
+
+            if (x >= width - maskWidth) {
+                right[y * maskWidth + x - width + maskWidth] = pixel;
+            }
+        }
+    }
+
+    jpeg_finish_decompress(&info);
+    jpeg_destroy_decompress(&info);
+    fclose(file);
+
+    return true;
+}
+#endif
+}
+
 BackgroundCache::BackgroundCache(QObject *parent)
     : QObject(parent),
       m_initialized(false),
       m_plasmaConfig(KSharedConfig::openConfig(PLASMACONFIG))
 {
+    qRegisterMetaType<EdgesHash>("EdgesHash");
+
+    //! wallpapers can be huge, they are decoded away from the gui thread
+    m_analysisPool.setMaxThreadCount(2);
+
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setInterval(5000);
+    connect(&m_saveTimer, &QTimer::timeout, this, &BackgroundCache::saveHintsFile);
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+            if (m_saveTimer.isActive()) {
+                m_saveTimer.stop();
+                saveHintsFile();
+            }
+        });
+    }
+
+    loadHintsFile();
+
     const auto configFile = QStandardPaths::writableLocation(
                 QStandardPaths::GenericConfigLocation) +
             QLatin1Char('/') + PLASMACONFIG;
@@ -64,6 +244,13 @@ BackgroundCache::BackgroundCache(QObject *parent)
 
 BackgroundCache::~BackgroundCache()
 {
+    m_analysisPool.clear();
+    m_analysisPool.waitForDone();
+
+    if (m_saveTimer.isActive()) {
+        saveHintsFile();
+    }
+
     if (m_pool) {
         m_pool->deleteLater();
     }
@@ -176,49 +363,57 @@ QString BackgroundCache::background(QString activity, QString screen)
     }
 }
 
-bool BackgroundCache::busyFor(QString activity, QString screen, Plasma::Types::Location location)
+bool BackgroundCache::hintsReady(QString activity, QString screen, Plasma::Types::Location location)
 {
     QString assignedBackground = background(activity, screen);
 
     if (!assignedBackground.isEmpty()) {
-        return busyForFile(assignedBackground, location);
+        return hintsReadyForFile(assignedBackground, location);
+    }
+
+    return true;
+}
+
+bool BackgroundCache::busyFor(QString activity, QString screen, Plasma::Types::Location location,
+                              float spanStart, float spanEnd)
+{
+    QString assignedBackground = background(activity, screen);
+
+    if (!assignedBackground.isEmpty()) {
+        return busyForFile(assignedBackground, location, spanStart, spanEnd);
     }
 
     return false;
 }
 
-float BackgroundCache::brightnessFor(QString activity, QString screen, Plasma::Types::Location location)
+float BackgroundCache::brightnessFor(QString activity, QString screen, Plasma::Types::Location location,
+                                     float spanStart, float spanEnd)
 {
     QString assignedBackground = background(activity, screen);
 
     if (!assignedBackground.isEmpty()) {
-        return brightnessForFile(assignedBackground, location);
+        return brightnessForFile(assignedBackground, location, spanStart, spanEnd);
     }
 
     return -1000;
 }
 
-float BackgroundCache::brightnessFromArea(QImage &image, int firstRow, int firstColumn, int endRow, int endColumn)
+std::vector<quint32> BackgroundCache::edgeProfile(const QImage &strip, Plasma::Types::Location location)
 {
-    float areaBrightness = -1000;
-
-    if (image.format() != QImage::Format_Invalid) {
-        for (int row = firstRow; row < endRow; ++row) {
-            QRgb *line = (QRgb *)image.scanLine(row);
+    const bool vertical = (location == Plasma::Types::LeftEdge || location == Plasma::Types::RightEdge);
+    std::vector<quint32> profile(vertical ? strip.height() : strip.width(), 0);
 
-            for (int col = firstColumn; col < endColumn ; ++col) {
-                QRgb pixelData = line[col];
-                float pixelBrightness = Latte::colorBrightness(pixelData);
+    for (int row = 0; row < strip.height(); ++row) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(strip.constScanLine(row));
 
-                areaBrightness = (areaBrightness == -1000) ? pixelBrightness : (areaBrightness + pixelBrightness);
-            }
+        if (vertical) {
+            profile[row] = static_cast<quint32>(Latte::pixelsBrightnessSum(line, strip.width()));
+        } else {
+            Latte::addPixelsBrightness(line, strip.width(), profile.data());
         }
-
-        float areaSize = (endRow - firstRow) * (endColumn - firstColumn);
-        areaBrightness = areaBrightness / areaSize;
     }
 
-    return areaBrightness;
+    return profile;
 }
 
 bool BackgroundCache::areaIsBusy(float bright1, float bright2)
@@ -233,155 +428,431 @@ bool BackgroundCache::areaIsBusy(float bright1, float bright2)
 
 //! In order to calculate the brightness and busy hints for specific image
 //! the code is doing the following. It is not needed to calculate these values
-//! for the entire image that would also be cpu costly. The function takes
-//! the location of the area in the image for which we are interested.
-//! The area is splitted in ten different subareas and for each one its brightness
+//! for the entire image that would also be cpu costly. Only the strip of the
+//! image along the edge in which we are interested is used.
+//! The strip is splitted in ten different subareas and for each one its brightness
 //! is computed. The brightness average from these areas provides the entire
 //! area brightness. In order to indicate if this area is busy or not we
 //! compare the minimum and the maximum values of brightness from these
 //! subareas. If the difference it too big then the area is busy
-void BackgroundCache::updateImageCalculations(QString imageFile, Plasma::Types::Location location)
+imageHints BackgroundCache::edgeCalculations(const QImage &strip, Plasma::Types::Location location)
 {
-    //! if it is a local image
-    QImage image(imageFile);
+    float maxBrightness{0};
+    float minBrightness{255};
 
-    if (image.format() != QImage::Format_Invalid) {
-        float brightness{-1000};
-        float maxBrightness{0};
-        float minBrightness{255};
+    bool vertical = (location == Plasma::Types::LeftEdge || location == Plasma::Types::RightEdge);
+    int stripLength = vertical ? strip.height() : strip.width();
+    int stripThickness = vertical ? strip.width() : strip.height();
+    int areas{qMin(10,stripLength)};
 
-        //! 24px. should be enough because the views are always snapped to edges
-        int maskHeight = qMin(24,image.height()); // (0.08 * image.height());
-        int maskWidth = qMin(24,image.width()); //(0.05 * image.width());
+    //! the strip is swept only once, all the subareas are computed from its profile
+    const std::vector<quint32> profile = edgeProfile(strip, location);
 
-        bool vertical = image.width() > image.height() ? false : true;
-        int imageLength = image.width() > image.height() ? image.width() : image.height();
-        int areas{qMin(10,imageLength)};
+    float subBrightnessSum = 0;
 
-        float factor = ((float)100/areas)/100;
+    for (int i=0; i<areas; ++i) {
+        int firstPos = (i * stripLength) / areas;
+        int endPos = ((i + 1) * stripLength) / areas;
 
-        QList<float> subBrightness;
+        quint64 areaSum{0};
 
-        //! Iterating algorigthm
-        int firstRow = 0; int firstColumn = 0; int endRow = 0; int endColumn = 0;
+        for (int pos = firstPos; pos < endPos; ++pos) {
+            areaSum += profile[pos];
+        }
 
-        //! horizontal mask calculations
-        if (location == Plasma::Types::TopEdge) {
-            firstRow = 0; endRow = maskHeight;
-        } else if (location == Plasma::Types::BottomEdge) {
-            firstRow = image.height() - maskHeight - 1; endRow = image.height() - 1;
+        float tempBrightness = static_cast<float>(areaSum) / (1000.0f * stripThickness * (endPos - firstPos));
+
+        subBrightnessSum = subBrightnessSum + tempBrightness;
+
+        if (tempBrightness > maxBrightness) {
+            maxBrightness = tempBrightness;
+        }
+        if (tempBrightness < minBrightness) {
+            minBrightness = tempBrightness;
         }
+    }
 
-        if (!vertical) {
-            for (int i=1; i<=areas; ++i) {
-                float subFactor = ((float)i) * factor;
-                firstColumn = endColumn+1; endColumn = (subFactor*imageLength) - 1;
-                endColumn = qMin(endColumn, imageLength-1);
-
-                int tempBrightness = brightnessFromArea(image, firstRow, firstColumn, endRow, endColumn);
-                subBrightness.append(tempBrightness);
-
-                if (tempBrightness > maxBrightness) {
-                    maxBrightness = tempBrightness;
-                }
-                if (tempBrightness < minBrightness) {
-                    minBrightness = tempBrightness;
-                }
-            }
+    //! compute total brightness for this area
+    float brightness = subBrightnessSum / areas;
+
+    bool areaBusy = areaIsBusy(minBrightness, maxBrightness);
+
+    imageHints iHints;
+    iHints.brightness = brightness; iHints.busy = areaBusy;
+
+    //! the sections are independent of the image size, that way
+    //! the stored hints stay small even for huge wallpapers
+    int sections{qMin(SPANSECTIONS, stripLength)};
+    iHints.brightnessSums.reserve(sections + 1);
+    iHints.brightnessSums.append(0);
+
+    double sectionsSum{0};
+
+    for (int i=0; i<sections; ++i) {
+        int firstPos = (i * stripLength) / sections;
+        int endPos = ((i + 1) * stripLength) / sections;
+
+        quint64 sectionSum{0};
+
+        for (int pos = firstPos; pos < endPos; ++pos) {
+            sectionSum += profile[pos];
+        }
+
+        sectionsSum += static_cast<double>(sectionSum) / (1000.0 * stripThickness * (endPos - firstPos));
+        iHints.brightnessSums.append(static_cast<float>(sectionsSum));
+    }
+
+    return iHints;
+}
+
+float BackgroundCache::spanBrightness(const QVector<float> &sums, float start, float end)
+{
+    const int sections = sums.count() - 1;
+
+    //! the brightness integral from the edge start until position
+    const auto integral = [&sums, sections](float position) {
+        const float pos = position * sections;
+        const int section = qMin(static_cast<int>(pos), sections - 1);
+
+        return sums[section] + (pos - section) * (sums[section + 1] - sums[section]);
+    };
+
+    const float length = (end - start) * sections;
+
+    if (length < 0.01f) {
+        //! a point of the edge, the brightness of its section
+        const int section = qMin(static_cast<int>(start * sections), sections - 1);
+        return sums[section + 1] - sums[section];
+    }
+
+    return (integral(end) - integral(start)) / length;
+}
+
+//! The span hints are computed the same way as the edge hints, the span is
+//! splitted in ten subareas whose brightness is measured from the prefix sums
+imageHints BackgroundCache::spanHints(const imageHints &edge, float spanStart, float spanEnd)
+{
+    const float start = qBound(0.0f, spanStart, 1.0f);
+    const float end = qBound(start, spanEnd, 1.0f);
+
+    //! the entire edge or images that were not analyzed
+    if ((start <= 0 && end >= 1) || edge.brightnessSums.count() < 2) {
+        return edge;
+    }
+
+    const int sections = edge.brightnessSums.count() - 1;
+    const int areas = qBound(1, static_cast<int>((end - start) * sections), 10);
+
+    float maxBrightness{0};
+    float minBrightness{255};
+    float subBrightnessSum{0};
+
+    for (int i=0; i<areas; ++i) {
+        float tempBrightness = spanBrightness(edge.brightnessSums,
+                                              start + (i * (end - start)) / areas,
+                                              start + ((i + 1) * (end - start)) / areas);
+
+        subBrightnessSum = subBrightnessSum + tempBrightness;
+        maxBrightness = qMax(maxBrightness, tempBrightness);
+        minBrightness = qMin(minBrightness, tempBrightness);
+    }
+
+    imageHints iHints;
+    iHints.brightness = subBrightnessSum / areas;
+    iHints.busy = areaIsBusy(minBrightness, maxBrightness);
+
+    return iHints;
+}
+
+QHash<Plasma::Types::Location, QImage> BackgroundCache::edgeStrips(QString imageFile)
+{
+    QHash<Plasma::Types::Location, QImage> strips;
+
+    QImageReader reader(imageFile);
+
+#if HAVE_JPEG
+    //! jpeg is decoded once as a stream, clipped reads would decode again
+    //! every row above each strip
+    if (reader.format() == "jpeg" && jpegEdgeStrips(imageFile, strips)) {
+        return strips;
+    }
+#endif
+
+    QSize size = reader.size();
+
+    //! formats that can decode parts of the image decode only the edge strips,
+    //! that way huge wallpapers are never loaded entirely in memory
+    const bool clipped = size.isValid() && reader.supportsOption(QImageIOHandler::ClipRect);
+
+    QImage image;
+
+    if (!clipped) {
+        //! the rest, e.g. png, are decoded entirely only once for all edges
+        image = reader.read();
+        size = image.size();
+    }
+
+    if (size.isEmpty()) {
+        return strips;
+    }
+
+    const int maskHeight = qMin(STRIPTHICKNESS, size.height());
+    const int maskWidth = qMin(STRIPTHICKNESS, size.width());
+
+    const QHash<Plasma::Types::Location, QRect> rects{
+        {Plasma::Types::TopEdge, QRect(0, 0, size.width(), maskHeight)},
+        {Plasma::Types::BottomEdge, QRect(0, size.height() - maskHeight, size.width(), maskHeight)},
+        {Plasma::Types::LeftEdge, QRect(0, 0, maskWidth, size.height())},
+        {Plasma::Types::RightEdge, QRect(size.width() - maskWidth, 0, maskWidth, size.height())}
+    };
+
+    for (auto it = rects.constBegin(); it != rects.constEnd(); ++it) {
+        QImage strip;
+
+        if (clipped) {
+            QImageReader stripReader(imageFile);
+            stripReader.setClipRect(it.value());
+            strip = stripReader.read();
+        } else {
+            strip = image.copy(it.value());
         }
 
-        //! vertical mask calculations
-        if (location == Plasma::Types::LeftEdge) {
-            firstColumn = 0; endColumn = maskWidth;
-        } else if (location == Plasma::Types::RightEdge) {
-            firstColumn = image.width() - 1 - maskWidth; endColumn = image.width() - 1;
+        if (!strip.isNull()) {
+            strips[it.key()] = strip.convertToFormat(QImage::Format_ARGB32);
         }
+    }
 
-        if (vertical) {
-            for (int i=1; i<=areas; ++i) {
-                float subFactor = ((float)i) * factor;
-                firstRow = endRow+1; endRow = (subFactor*imageLength) - 1;
-                endRow = qMin(endRow, imageLength-1);
-
-                int tempBrightness = brightnessFromArea(image, firstRow, firstColumn, endRow, endColumn);
-                subBrightness.append(tempBrightness);
-
-                if (tempBrightness > maxBrightness) {
-                    maxBrightness = tempBrightness;
-                }
-                if (tempBrightness < minBrightness) {
-                    minBrightness = tempBrightness;
-                }
-            }
+    return strips;
+}
+
+EdgesHash BackgroundCache::imageCalculations(QString imageFile)
+{
+    EdgesHash hints;
+
+    qDebug() << " Hints for Background image: " << imageFile;
+
+    //! if it is a local image, all the edges are calculated in a single pass
+    QHash<Plasma::Types::Location, QImage> strips = edgeStrips(imageFile);
+
+    for (const auto location : {Plasma::Types::TopEdge, Plasma::Types::BottomEdge,
+                                Plasma::Types::LeftEdge, Plasma::Types::RightEdge}) {
+        //! images that can not be read keep the neutral hints
+        hints[location] = strips.contains(location) ? edgeCalculations(strips[location], location) : imageHints();
+    }
+
+    return hints;
+}
+
+bool BackgroundCache::isAnalyzed(const EdgesHash &hints)
+{
+    for (const auto location : {Plasma::Types::TopEdge, Plasma::Types::BottomEdge,
+                                Plasma::Types::LeftEdge, Plasma::Types::RightEdge}) {
+        //! the edge sums exist only for decoded edges
+        if (!hints.contains(location) || hints[location].brightnessSums.isEmpty()) {
+            return false;
         }
-        //! compute total brightness for this area
-        float subBrightnessSum = 0;
+    }
+
+    return true;
+}
+
+QByteArray BackgroundCache::contentHash(QString imageFile)
+{
+    QFile file(imageFile);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+
+    return hash.result();
+}
+
+void BackgroundCache::requestImageCalculations(QString imageFile)
+{
+    if (m_pendingFiles.contains(imageFile)) {
+        return;
+    }
+
+    const QFileInfo info(imageFile);
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    const qint64 size = info.size();
+
+    auto stored = m_storedHints.constFind(imageFile);
+
+    if (stored != m_storedHints.constEnd() && stored->modified == modified && stored->size == size) {
+        m_hintsCache[imageFile] = stored->hints;
+        return;
+    }
 
-        for (int i=0; i<subBrightness.count(); ++i) {
-            subBrightnessSum = subBrightnessSum + subBrightness[i];
+    //! the same content may have been analyzed already under a different
+    //! path or modification time, it is checked in the analysis thread
+    QHash<QByteArray, EdgesHash> storedContents;
+
+    for (const auto &hints : m_storedHints) {
+        storedContents[hints.hash] = hints.hints;
+    }
+
+    m_pendingFiles.insert(imageFile);
+
+    m_analysisPool.start(new AnalysisJob([this, imageFile, modified, size, storedContents]() {
+        QByteArray hash = contentHash(imageFile);
+        const EdgesHash hints = !hash.isEmpty() && storedContents.contains(hash) ?
+                    storedContents[hash] : imageCalculations(imageFile);
+
+        //! images that could not be decoded, e.g. they are still written,
+        //! are not stored and they are analyzed again in the next session
+        if (!isAnalyzed(hints)) {
+            hash.clear();
+        }
+
+        QMetaObject::invokeMethod(this, "imageCalculated", Qt::QueuedConnection,
+                                  Q_ARG(QString, imageFile), Q_ARG(EdgesHash, hints),
+                                  Q_ARG(QByteArray, hash), Q_ARG(qint64, modified), Q_ARG(qint64, size));
+    }));
+}
+
+void BackgroundCache::imageCalculated(const QString &imageFile, const EdgesHash &hints,
+                                      const QByteArray &hash, qint64 modified, qint64 size)
+{
+    m_pendingFiles.remove(imageFile);
+    m_hintsCache[imageFile] = hints;
+
+    //! files that can not be read or decoded are not stored
+    if (!hash.isEmpty()) {
+        StoredHints &stored = m_storedHints[imageFile];
+        stored.modified = modified;
+        stored.size = size;
+        stored.hash = hash;
+        stored.hints = hints;
+
+        if (!m_saveTimer.isActive()) {
+            m_saveTimer.start();
         }
+    }
+
+    emit hintsChanged(imageFile);
+}
+
+QString BackgroundCache::hintsFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/lattedock/backgroundhints";
+}
+
+void BackgroundCache::loadHintsFile()
+{
+    QFile file(hintsFilePath());
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic{0};
+    qint32 version{0};
+    qint32 count{0};
+
+    stream >> magic >> version >> count;
+
+    if (magic != HINTSFILEMAGIC || version != HINTSFILEVERSION) {
+        qDebug() << "background hints file is not valid and it is ignored...";
+        return;
+    }
 
-        brightness = subBrightnessSum / subBrightness.count();
+    for (int i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString imageFile;
+        StoredHints stored;
+        qint32 edges{0};
 
-        bool areaBusy = areaIsBusy(minBrightness, maxBrightness);
+        stream >> imageFile >> stored.modified >> stored.size >> stored.hash >> edges;
 
-        qDebug() << " Hints for Background image: " << imageFile;
-        qDebug() << " Brightness: " << brightness << " Busy: " << areaBusy << " minBright:" << minBrightness << " maxBright:" << maxBrightness;
+        for (int j = 0; j < edges && stream.status() == QDataStream::Ok; ++j) {
+            qint32 location{0};
+            imageHints hints;
 
-        if (!m_hintsCache.keys().contains(imageFile)) {
-            m_hintsCache[imageFile] = EdgesHash();
+            stream >> location >> hints.busy >> hints.brightness >> hints.brightnessSums;
+            stored.hints[static_cast<Plasma::Types::Location>(location)] = hints;
         }
 
-        if (!m_hintsCache[imageFile].contains(location)) {
-            imageHints iHints;
-            iHints.brightness = brightness; iHints.busy = areaBusy;
-            m_hintsCache[imageFile].insert(location, iHints);
-        } else {
-            m_hintsCache[imageFile][location].brightness = brightness;
-            m_hintsCache[imageFile][location].busy = areaBusy;
+        if (stream.status() == QDataStream::Ok) {
+            m_storedHints[imageFile] = stored;
         }
     }
 }
 
-float BackgroundCache::brightnessForFile(QString imageFile, Plasma::Types::Location location)
+void BackgroundCache::saveHintsFile()
 {
-    if (m_hintsCache.keys().contains(imageFile)) {
-        if (m_hintsCache[imageFile].keys().contains(location)) {
-            return m_hintsCache[imageFile][location].brightness;
+    //! forget the images that do not exist any more
+    for (auto it = m_storedHints.begin(); it != m_storedHints.end();) {
+        it = QFileInfo::exists(it.key()) ? it + 1 : m_storedHints.erase(it);
+    }
+
+    const QString path = hintsFilePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QFile file(path);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "background hints file" << path << "can not be written...";
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    stream << static_cast<quint32>(HINTSFILEMAGIC) << static_cast<qint32>(HINTSFILEVERSION)
+           << static_cast<qint32>(m_storedHints.count());
+
+    for (auto it = m_storedHints.constBegin(); it != m_storedHints.constEnd(); ++it) {
+        stream << it.key() << it->modified << it->size << it->hash << static_cast<qint32>(it->hints.count());
+
+        for (auto edge = it->hints.constBegin(); edge != it->hints.constEnd(); ++edge) {
+            stream << static_cast<qint32>(edge.key()) << edge->busy << edge->brightness << edge->brightnessSums;
         }
     }
+}
 
+bool BackgroundCache::hintsReadyForFile(QString imageFile, Plasma::Types::Location location)
+{
+    if (imageFile.startsWith("#")) {
+        return true;
+    }
+
+    if (!m_hintsCache.contains(imageFile)) {
+        //! stored hints are available immediately
+        requestImageCalculations(imageFile);
+    }
+
+    return m_hintsCache.contains(imageFile) && m_hintsCache[imageFile].contains(location);
+}
+
+float BackgroundCache::brightnessForFile(QString imageFile, Plasma::Types::Location location, float spanStart, float spanEnd)
+{
     //! if it is a color
     if (imageFile.startsWith("#")) {
         return Latte::colorBrightness(QColor(imageFile));
     }
 
-    updateImageCalculations(imageFile, location);
-
-    if (m_hintsCache.keys().contains(imageFile)) {
-        return m_hintsCache[imageFile][location].brightness;
+    if (hintsReadyForFile(imageFile, location)) {
+        return spanHints(m_hintsCache[imageFile][location], spanStart, spanEnd).brightness;
     }
 
     return -1000;
 }
 
-bool BackgroundCache::busyForFile(QString imageFile, Plasma::Types::Location location)
+bool BackgroundCache::busyForFile(QString imageFile, Plasma::Types::Location location, float spanStart, float spanEnd)
 {
-    if (m_hintsCache.keys().contains(imageFile)) {
-        if (m_hintsCache[imageFile].keys().contains(location)) {
-            return m_hintsCache[imageFile][location].busy;
-        }
-    }
-
     //! if it is a color
     if (imageFile.startsWith("#")) {
         return false;
     }
 
-    updateImageCalculations(imageFile, location);
-
-    if (m_hintsCache.keys().contains(imageFile)) {
-        return m_hintsCache[imageFile][location].busy;
+    if (hintsReadyForFile(imageFile, location)) {
+        return spanHints(m_hintsCache[imageFile][location], spanStart, spanEnd).busy;
     }
 
     return false;
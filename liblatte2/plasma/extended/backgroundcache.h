@@ -23,9 +23,18 @@
 // local
 #include "screenpool.h"
 
+// C++
+#include <vector>
+
 // Qt
 #include <QHash>
+#include <QImage>
+#include <QMetaType>
 #include <QObject>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
 
 // Plasma
 #include <Plasma>
@@ -37,10 +46,15 @@
 struct imageHints {
     bool busy{false};
     float brightness{-1000};
+    //! prefix sums of the mean brightness of the edge sections, any span
+    //! of the edge can be measured from them without decoding the image again
+    QVector<float> brightnessSums;
 };
 
 typedef QHash<Plasma::Types::Location, imageHints> EdgesHash;
 
+Q_DECLARE_METATYPE(EdgesHash)
+
 namespace Latte {
 namespace PlasmaExtended {
 
@@ -52,30 +66,58 @@ public:
     static BackgroundCache *self();
     ~BackgroundCache() override;
 
-    bool busyFor(QString activity, QString screen, Plasma::Types::Location location);
-    float brightnessFor(QString activity, QString screen, Plasma::Types::Location location);
+    //! images are analyzed asynchronously, until their hints are ready
+    //! a neutral state is returned, not busy and unknown brightness.
+    //! The span is the part of the edge that is measured, as fractions of its length
+    bool hintsReady(QString activity, QString screen, Plasma::Types::Location location);
+    bool busyFor(QString activity, QString screen, Plasma::Types::Location location,
+                 float spanStart = 0, float spanEnd = 1);
+    float brightnessFor(QString activity, QString screen, Plasma::Types::Location location,
+                        float spanStart = 0, float spanEnd = 1);
 
     QString background(QString activity, QString screen);
 
+    //! the hints of an edge strip that is already decoded, it does not depend
+    //! on any cache state and it is also used by the brightness benchmark
+    static imageHints edgeCalculations(const QImage &strip, Plasma::Types::Location location);
+
 signals:
     void backgroundChanged(const QString &activity, const QString &screenName);
+    //! the hints of an image file were calculated
+    void hintsChanged(const QString &imageFile);
 
 private slots:
     void reload();
     void settingsFileChanged(const QString &file);
+    void imageCalculated(const QString &imageFile, const EdgesHash &hints,
+                         const QByteArray &hash, qint64 modified, qint64 size);
+    void saveHintsFile();
 
 private:
     BackgroundCache(QObject *parent = nullptr);
 
-    bool areaIsBusy(float bright1, float bright2);
-    bool busyForFile(QString imageFile, Plasma::Types::Location location);
+    bool busyForFile(QString imageFile, Plasma::Types::Location location, float spanStart, float spanEnd);
+    bool hintsReadyForFile(QString imageFile, Plasma::Types::Location location);
     bool isDesktopContainment(const KConfigGroup &containment) const;
 
-    float brightnessForFile(QString imageFile, Plasma::Types::Location location);
-    float brightnessFromArea(QImage &image, int firstRow, int firstColumn, int endRow, int endColumn);
+    float brightnessForFile(QString imageFile, Plasma::Types::Location location, float spanStart, float spanEnd);
     QString backgroundFromConfig(const KConfigGroup &config) const;
 
-    void updateImageCalculations(QString imageFile, Plasma::Types::Location location);
+    void requestImageCalculations(QString imageFile);
+
+    void loadHintsFile();
+    static QString hintsFilePath();
+
+    //! they run in the analysis threads
+    static bool areaIsBusy(float bright1, float bright2);
+    //! brightness sums across the strip thickness for each position along the edge
+    static std::vector<quint32> edgeProfile(const QImage &strip, Plasma::Types::Location location);
+    static float spanBrightness(const QVector<float> &sums, float start, float end);
+    static imageHints spanHints(const imageHints &edge, float spanStart, float spanEnd);
+    static QHash<Plasma::Types::Location, QImage> edgeStrips(QString imageFile);
+    static EdgesHash imageCalculations(QString imageFile);
+    static QByteArray contentHash(QString imageFile);
+    static bool isAnalyzed(const EdgesHash &hints);
 
 private:
     bool m_initialized{false};
@@ -87,6 +129,23 @@ private:
     //! image file and brightness per edge
     QHash<QString, EdgesHash> m_hintsCache;
 
+    //! image files that are analyzed right now
+    QSet<QString> m_pendingFiles;
+    QThreadPool m_analysisPool;
+
+    //! hints that are kept between sessions, an image is not analyzed again
+    //! when its path, modification time and size or its content are the same
+    struct StoredHints {
+        qint64 modified{0};
+        qint64 size{0};
+        QByteArray hash;
+        EdgesHash hints;
+    };
+
+    QHash<QString, StoredHints> m_storedHints;
+    //! the hints file is written lazily
+    QTimer m_saveTimer;
+
     KSharedConfig::Ptr m_plasmaConfig;
 };
 
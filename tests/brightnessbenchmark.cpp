@@ -0,0 +1,197 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//! Developers tool, it measures the wallpaper edge brightness calculations of the
+//! background cache on synthetic 4K and 8K images. The per pixel float implementation
+//! that was used before the integer brightness kernels is the reference, both for
+//! the timings and for the calculated hints.
+
+// local
+#include "commontools.h"
+#include "plasma/extended/backgroundcache.h"
+
+// C++
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Qt
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QRgb>
+#include <QtMath>
+
+// Plasma
+#include <Plasma>
+
+namespace {
+
+const int Runs{21};
+const int Areas{10};
+const int StripThickness{24};
+
+struct Strip {
+    Plasma::Types::Location location;
+    QImage image;
+};
+
+//! the per pixel float calculation of the edge hints
+imageHints referenceHints(const QImage &strip, Plasma::Types::Location location)
+{
+    const bool vertical = (location == Plasma::Types::LeftEdge || location == Plasma::Types::RightEdge);
+    const int length = vertical ? strip.height() : strip.width();
+    const int areas = qMin(Areas, length);
+
+    float brightness{0};
+    float minBrightness{255};
+    float maxBrightness{0};
+
+    for (int i = 0; i < areas; ++i) {
+        const int firstPos = (i * length) / areas;
+        const int endPos = ((i + 1) * length) / areas;
+
+        const int firstRow = vertical ? firstPos : 0;
+        const int endRow = vertical ? endPos : strip.height();
+        const int firstColumn = vertical ? 0 : firstPos;
+        const int endColumn = vertical ? strip.width() : endPos;
+
+        float areaBrightness = -1000;
+
+        for (int row = firstRow; row < endRow; ++row) {
+            const QRgb *line = reinterpret_cast<const QRgb *>(strip.constScanLine(row));
+
+            for (int col = firstColumn; col < endColumn; ++col) {
+                float pixelBrightness = Latte::colorBrightness(line[col]);
+                areaBrightness = (areaBrightness == -1000) ? pixelBrightness : (areaBrightness + pixelBrightness);
+            }
+        }
+
+        areaBrightness = areaBrightness / ((endRow - firstRow) * (endColumn - firstColumn));
+
+        brightness += areaBrightness;
+        minBrightness = qMin(minBrightness, areaBrightness);
+        maxBrightness = qMax(maxBrightness, areaBrightness);
+    }
+
+    const bool inBounds = minBrightness >= 0 && maxBrightness <= 255;
+
+    imageHints hints;
+    hints.brightness = brightness / areas;
+    hints.busy = !inBounds || ((minBrightness >= 123) != (maxBrightness >= 123));
+
+    return hints;
+}
+
+QImage randomImage(int width, int height)
+{
+    QImage image(width, height, QImage::Format_ARGB32);
+
+    std::mt19937 generator(width);
+    std::uniform_int_distribution<quint32> channel(0, 255);
+
+    //! smooth gradients with noise, similar to photographic wallpapers
+    for (int row = 0; row < height; ++row) {
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(row));
+
+        for (int col = 0; col < width; ++col) {
+            const int base = (col * 255) / width;
+            const int noise = static_cast<int>(channel(generator)) / 8;
+
+            line[col] = qRgb(qMin(255, base + noise), qMin(255, (row * 255) / height + noise), qMin(255, noise * 4));
+        }
+    }
+
+    return image;
+}
+
+std::vector<Strip> edgeStrips(const QImage &image)
+{
+    return {
+        {Plasma::Types::TopEdge, image.copy(0, 0, image.width(), StripThickness)},
+        {Plasma::Types::BottomEdge, image.copy(0, image.height() - StripThickness, image.width(), StripThickness)},
+        {Plasma::Types::LeftEdge, image.copy(0, 0, StripThickness, image.height())},
+        {Plasma::Types::RightEdge, image.copy(image.width() - StripThickness, 0, StripThickness, image.height())}
+    };
+}
+
+}
+
+int main()
+{
+    const QList<QSize> sizes{{3840, 2160}, {7680, 4320}};
+
+    for (const auto &size : sizes) {
+        const QImage image = randomImage(size.width(), size.height());
+
+        //! the edge strips and the entire image as one more strip
+        const std::vector<std::vector<Strip>> targets{edgeStrips(image), {{Plasma::Types::TopEdge, image}}};
+
+        for (size_t target = 0; target < targets.size(); ++target) {
+            const std::vector<Strip> &strips = targets[target];
+
+            std::vector<qint64> referenceTimes;
+            std::vector<qint64> cacheTimes;
+            float difference{0};
+            int busyMismatches{0};
+
+            for (int run = 0; run < Runs; ++run) {
+                QElapsedTimer timer;
+                std::vector<imageHints> reference;
+                std::vector<imageHints> cache;
+
+                timer.start();
+
+                for (const auto &strip : strips) {
+                    reference.push_back(referenceHints(strip.image, strip.location));
+                }
+
+                referenceTimes.push_back(timer.nsecsElapsed());
+                timer.restart();
+
+                for (const auto &strip : strips) {
+                    cache.push_back(Latte::PlasmaExtended::BackgroundCache::edgeCalculations(strip.image, strip.location));
+                }
+
+                cacheTimes.push_back(timer.nsecsElapsed());
+
+                for (size_t i = 0; i < reference.size(); ++i) {
+                    difference = qMax(difference, qAbs(reference[i].brightness - cache[i].brightness));
+                    busyMismatches += (reference[i].busy != cache[i].busy) ? 1 : 0;
+                }
+            }
+
+            std::sort(referenceTimes.begin(), referenceTimes.end());
+            std::sort(cacheTimes.begin(), cacheTimes.end());
+
+            const qint64 referenceMedian = referenceTimes[Runs / 2];
+            const qint64 cacheMedian = cacheTimes[Runs / 2];
+
+            qInfo().noquote() << QString("%1x%2 %3 :: float per pixel: %4 ms, background cache: %5 ms, speedup: %6x, max difference: %7, busy mismatches: %8")
+                      .arg(size.width()).arg(size.height())
+                      .arg(target == 0 ? "edge strips" : "full image")
+                      .arg(referenceMedian / 1000000.0, 0, 'f', 3)
+                      .arg(cacheMedian / 1000000.0, 0, 'f', 3)
+                      .arg(cacheMedian > 0 ? (double)referenceMedian / cacheMedian : 0, 0, 'f', 2)
+                      .arg(difference, 0, 'f', 4)
+                      .arg(busyMismatches);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+/*
+*  Copyright 2019  Michail Vourlakos <mvourlakos@gmail.com>
+*
+*  This file is part of Latte-Dock
+*
+*  Latte-Dock is free software; you can redistribute it and/or
+*  modify it under the terms of the GNU General Public License as
+*  published by the Free Software Foundation; either version 2 of
+*  the License, or (at your option) any later version.
+*
+*  Latte-Dock is distributed in the hope that it will be useful,
+*  but WITHOUT ANY WARRANTY; without even the implied warranty of
+*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*  GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License
+*  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//! Developers tool, a recorded windows trace is replayed through the synthetic
+//! window tracking for every dodge visibility mode. The windows decisions of four
+//! views, one for each screen edge, are measured without any live session, views
+//! or layouts and without touching any configuration.
+
+// local
+#include "schemesregistry.h"
+#include "view/visibilityprofiler.h"
+#include "view/windowsdodger.h"
+#include "wm/syntheticwindowinterface.h"
+#include "wm/windowstraceplayer.h"
+#include "../liblatte2/types.h"
+
+// C++
+#include <algorithm>
+#include <memory>
+#include <time.h>
+#include <vector>
+
+// Qt
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QMetaEnum>
+
+// Plasma
+#include <Plasma>
+
+namespace {
+
+const int ViewThickness{64};
+
+struct View {
+    Plasma::Types::Location location;
+    std::unique_ptr<Latte::ViewPart::VisibilityProfiler> profiler;
+    std::unique_ptr<Latte::ViewPart::WindowsDodger> dodger;
+    int raises{0};
+    int hides{0};
+};
+
+qint64 threadCpuTime()
+{
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+
+    return static_cast<qint64>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+qint64 percentile(const std::vector<qint64> &sorted, int percent)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+
+    const size_t pos = (sorted.size() * percent + 99) / 100;
+
+    return sorted[qMax<size_t>(pos, 1) - 1];
+}
+
+QRect viewGeometry(const QRect &screenGeometry, Plasma::Types::Location location)
+{
+    switch (location) {
+        case Plasma::Types::TopEdge:
+            return QRect(screenGeometry.left(), screenGeometry.top(), screenGeometry.width(), ViewThickness);
+
+        case Plasma::Types::LeftEdge:
+            return QRect(screenGeometry.left(), screenGeometry.top(), ViewThickness, screenGeometry.height());
+
+        case Plasma::Types::RightEdge:
+            return QRect(screenGeometry.right() - ViewThickness + 1, screenGeometry.top(), ViewThickness, screenGeometry.height());
+
+        default:
+            return QRect(screenGeometry.left(), screenGeometry.bottom() - ViewThickness + 1, screenGeometry.width(), ViewThickness);
+    }
+}
+
+void runMode(Latte::Types::Visibility mode, const QString &file, const QRect &screenGeometry)
+{
+    //! a fresh windows tracking for every mode, the trace starts always from the same windows
+    Latte::SyntheticWindowInterface wm(nullptr);
+    Latte::WindowsTracePlayer player(&wm, file);
+
+    std::vector<View> views;
+
+    for (const auto location : {Plasma::Types::BottomEdge, Plasma::Types::TopEdge
+                                , Plasma::Types::LeftEdge, Plasma::Types::RightEdge}) {
+        View view;
+        view.location = location;
+        view.profiler.reset(new Latte::ViewPart::VisibilityProfiler());
+        view.dodger.reset(new Latte::ViewPart::WindowsDodger(&wm, view.profiler.get()));
+
+        view.dodger->setScreenGeometry(screenGeometry);
+        view.dodger->setViewGeometry(viewGeometry(screenGeometry, location));
+        view.dodger->setFormFactor((location == Plasma::Types::LeftEdge || location == Plasma::Types::RightEdge) ?
+                                   Plasma::Types::Vertical : Plasma::Types::Horizontal);
+        view.dodger->setMode(mode);
+
+        views.push_back(std::move(view));
+    }
+
+    for (auto &view : views) {
+        View *v = &view;
+        QObject::connect(v->dodger.get(), &Latte::ViewPart::WindowsDodger::raiseRequested, [v](bool raise) {
+            if (raise) {
+                ++v->raises;
+            } else {
+                ++v->hides;
+            }
+        });
+    }
+
+    std::vector<qint64> latencies;
+
+    QElapsedTimer timer;
+    const qint64 cpuStart = threadCpuTime();
+
+    timer.start();
+
+    while (player.playNextEvent()) {
+        latencies.push_back(timer.nsecsElapsed());
+        timer.restart();
+    }
+
+    const qint64 cpuTime = threadCpuTime() - cpuStart;
+
+    int raises{0};
+    int hides{0};
+
+    for (const auto &view : views) {
+        raises += view.raises;
+        hides += view.hides;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    qInfo().noquote() << QStringLiteral("%1 events: %2 p50: %3us p90: %4us p99: %5us max: %6us cpu: %7ms raises: %8 hides: %9")
+                      .arg(QMetaEnum::fromType<Latte::Types::Visibility>().valueToKey(mode), -16)
+                      .arg(latencies.size())
+                      .arg(percentile(latencies, 50) / 1000.0, 0, 'f', 1)
+                      .arg(percentile(latencies, 90) / 1000.0, 0, 'f', 1)
+                      .arg(percentile(latencies, 99) / 1000.0, 0, 'f', 1)
+                      .arg(latencies.empty() ? 0 : latencies.back() / 1000.0, 0, 'f', 1)
+                      .arg(cpuTime / 1000000.0, 0, 'f', 1)
+                      .arg(raises)
+                      .arg(hides);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replays a windows trace recorded by latte-dock --record-windows for every dodge visibility mode and prints the latency percentiles of the windows decisions."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("trace"), QStringLiteral("The recorded windows trace file."));
+
+    QCommandLineOption screenOption(QStringLiteral("screen"), QStringLiteral("The screen size of the views, [default: 1920x1080]."), QStringLiteral("WxH"), QStringLiteral("1920x1080"));
+    parser.addOption(screenOption);
+
+    parser.process(app);
+
+    if (parser.positionalArguments().count() != 1) {
+        parser.showHelp(1);
+    }
+
+    const QString file = parser.positionalArguments().first();
+
+    if (!Latte::WindowsTracePlayer::isTrace(file)) {
+        qWarning() << "windows benchmark: file" << file << "is not a valid windows trace...";
+        return 1;
+    }
+
+    const QStringList size = parser.value(screenOption).split(QLatin1Char('x'));
+    const QRect screenGeometry(0, 0, size.value(0).toInt(), size.value(1).toInt());
+
+    if (screenGeometry.isEmpty()) {
+        qWarning() << "windows benchmark: screen size" << parser.value(screenOption) << "is not valid...";
+        return 1;
+    }
+
+    //! the windows tracking follows the color schemes registry
+    Latte::SchemesRegistry schemes;
+
+    for (const auto mode : {Latte::Types::DodgeActive, Latte::Types::DodgeMaximized, Latte::Types::DodgeAllWindows}) {
+        runMode(mode, file, screenGeometry);
+    }
+
+    return 0;
+}